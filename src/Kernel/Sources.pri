@@ -11,10 +11,15 @@ HEADERS += $$PWD/src/KernelLib.h \
            $$PWD/src/ScreenieControl.h \
            $$PWD/src/ScreenieGraphicsScene.h \
            $$PWD/src/ScreeniePixmapItem.h \
+           $$PWD/src/ItemUpdateScheduler.h \
            $$PWD/src/TemplateOrganizer.h \
+           $$PWD/src/ImageFileWatcher.h \
+           $$PWD/src/ScreenieSceneWriter.h \
+           $$PWD/src/AutoSaveJournal.h \
            $$PWD/src/Clipboard/Clipboard.h \
            $$PWD/src/Clipboard/ScreenieMimeData.h \
            $$PWD/src/Clipboard/MimeHelper.h \
+           $$PWD/src/Clipboard/SharedMemoryTransfer.h \
            $$PWD/src/PropertyDialogFactory.h \
            $$PWD/src/DocumentManager.h \
            $$PWD/src/DocumentInfo.h \
@@ -33,10 +38,15 @@ SOURCES += $$PWD/src/ExportImage.cpp \
            $$PWD/src/ScreenieControl.cpp \
            $$PWD/src/ScreenieGraphicsScene.cpp \
            $$PWD/src/ScreeniePixmapItem.cpp \
+           $$PWD/src/ItemUpdateScheduler.cpp \
            $$PWD/src/TemplateOrganizer.cpp \
+           $$PWD/src/ImageFileWatcher.cpp \
+           $$PWD/src/ScreenieSceneWriter.cpp \
+           $$PWD/src/AutoSaveJournal.cpp \
            $$PWD/src/Clipboard/Clipboard.cpp \
            $$PWD/src/Clipboard/ScreenieMimeData.cpp \
            $$PWD/src/Clipboard/MimeHelper.cpp \
+           $$PWD/src/Clipboard/SharedMemoryTransfer.cpp \
            $$PWD/src/PropertyDialogFactory.cpp \
            $$PWD/src/DocumentManager.cpp \
            $$PWD/src/Dialogs/ScreenieModelPropertiesDialog.cpp \
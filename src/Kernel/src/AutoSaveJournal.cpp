@@ -0,0 +1,739 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QByteArray>
+#include <QtCore/QBitArray>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QList>
+#include <QtCore/QPointF>
+#include <QtCore/QSize>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QTimer>
+#include <QtCore/QDataStream>
+#include <QtCore/QCoreApplication>
+#include <QtGui/QColor>
+#include <QtGui/QDesktopServices>
+
+#ifdef Q_OS_UNIX
+#include <sys/types.h>
+#include <signal.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <io.h>
+#endif
+
+#include "../../Utils/src/FileUtils.h"
+#include "../../Utils/src/SizeFitter.h"
+#include "../../Utils/src/Version.h"
+#include "../../Model/src/ScreenieScene.h"
+#include "../../Model/src/ScreenieModelInterface.h"
+#include "../../Model/src/ScreenieFilePathModel.h"
+#include "../../Model/src/ScreenieImageModel.h"
+#include "../../Model/src/ScreenieTemplateModel.h"
+#include "AutoSaveJournal.h"
+
+class AutoSaveJournalPrivate
+{
+public:
+    AutoSaveJournalPrivate(const ScreenieScene &theScreenieScene)
+        : screenieScene(theScreenieScene),
+          nextModelId(0),
+          sceneChanged(true),
+          compactionPending(true),
+          recordCount(0)
+    {
+        journalPath = getAutoSavePath() + QString("/%1-%2").arg(QCoreApplication::applicationPid()).arg(++instanceCount);
+        flushTimer.setSingleShot(true);
+        flushTimer.setInterval(FlushDelay);
+    }
+
+    enum RecordType
+    {
+        SceneRecord = 0,
+        ModelRecord = 1,
+        RemoveRecord = 2
+    };
+
+    enum ModelType
+    {
+        FilePathModel = 0,
+        ImageModel = 1,
+        TemplateModel = 2
+    };
+
+    static const char Magic[];
+    static const int MagicLength;
+    static const quint32 FormatVersion;
+    static const QDataStream::Version DataStreamVersion;
+    // msecs
+    static const int FlushDelay;
+    // the number of appended records after which the journal is compacted
+    static const int CompactionThreshold;
+    static int instanceCount;
+
+    const ScreenieScene &screenieScene;
+    QString journalPath;
+    QTimer flushTimer;
+    QHash<const ScreenieModelInterface *, quint32> modelIds;
+    quint32 nextModelId;
+    QSet<const ScreenieModelInterface *> changedModels;
+    QList<quint32> removedModelIds;
+    // the hashes of the images in the image store, by model
+    QHash<const ScreenieModelInterface *, QByteArray> imageHashes;
+    bool sceneChanged;
+    bool compactionPending;
+    int recordCount;
+
+    static QString getAutoSavePath()
+    {
+        return QDesktopServices::storageLocation(QDesktopServices::DataLocation) + "/" + Version::getApplicationName() + "/AutoSave";
+    }
+
+    static QString getJournalFilePath(const QString &journalPath)
+    {
+        return journalPath + "/journal";
+    }
+
+    static QString getImageStorePath(const QString &journalPath)
+    {
+        return journalPath + "/images";
+    }
+
+    static QString getImageFilePath(const QString &journalPath, const QByteArray &hash)
+    {
+        return getImageStorePath(journalPath) + "/" + QString::fromLatin1(hash) + ".png";
+    }
+
+    static bool isRunning(qint64 pid)
+    {
+        bool result;
+#ifdef Q_OS_UNIX
+        result = ::kill(static_cast<pid_t>(pid), 0) == 0 || errno == EPERM;
+#elif defined(Q_OS_WIN)
+        HANDLE process = ::OpenProcess(PROCESS_QUERY_INFORMATION, FALSE, static_cast<DWORD>(pid));
+        if (process != 0) {
+            DWORD exitCode;
+            result = ::GetExitCodeProcess(process, &exitCode) == 0 || exitCode == STILL_ACTIVE;
+            ::CloseHandle(process);
+        } else {
+            // the process exists, but may not be queried
+            result = ::GetLastError() == ERROR_ACCESS_DENIED;
+        }
+#else
+        // liveness is unknown: the journal must not be recovered (and removed)
+        // while its application instance might still be running
+        Q_UNUSED(pid)
+        result = true;
+#endif
+        return result;
+    }
+
+    /*
+     * Writes the flushed data of the open 'file' through to the disk.
+     */
+    static bool sync(QFile &file)
+    {
+        bool result;
+#ifdef Q_OS_UNIX
+        result = ::fsync(file.handle()) == 0;
+#elif defined(Q_OS_WIN)
+        result = ::FlushFileBuffers(reinterpret_cast<HANDLE>(::_get_osfhandle(file.handle()))) != 0;
+#else
+        Q_UNUSED(file)
+        result = true;
+#endif
+        return result;
+    }
+
+    static void writeHeader(QDataStream &dataStream)
+    {
+        dataStream.writeRawData(Magic, MagicLength);
+        dataStream << FormatVersion;
+    }
+
+    static bool readHeader(QDataStream &dataStream)
+    {
+        bool result;
+        char magic[8];
+        quint32 formatVersion;
+        result = dataStream.readRawData(magic, MagicLength) == MagicLength &&
+                 qstrncmp(magic, Magic, MagicLength) == 0;
+        if (result) {
+            dataStream >> formatVersion;
+            result = dataStream.status() == QDataStream::Ok && formatVersion == FormatVersion;
+        }
+        return result;
+    }
+
+    static void writeProperties(QDataStream &dataStream, const ScreenieModelInterface &screenieModel)
+    {
+        dataStream << screenieModel.getPosition();
+        dataStream << static_cast<double>(screenieModel.getDistance());
+        dataStream << static_cast<qint32>(screenieModel.getRotation());
+        dataStream << screenieModel.isReflectionEnabled();
+        dataStream << static_cast<qint32>(screenieModel.getReflectionOffset());
+        dataStream << static_cast<qint32>(screenieModel.getReflectionOpacity());
+    }
+
+    static bool readProperties(QDataStream &dataStream, ScreenieModelInterface &screenieModel)
+    {
+        QPointF position;
+        double distance;
+        qint32 rotation;
+        bool reflectionEnabled;
+        qint32 reflectionOffset;
+        qint32 reflectionOpacity;
+        dataStream >> position >> distance >> rotation >> reflectionEnabled >> reflectionOffset >> reflectionOpacity;
+        bool result = dataStream.status() == QDataStream::Ok;
+        if (result) {
+            screenieModel.setPosition(position);
+            screenieModel.setDistance(distance);
+            screenieModel.setRotation(rotation);
+            screenieModel.setReflectionEnabled(reflectionEnabled);
+            screenieModel.setReflectionOffset(reflectionOffset);
+            screenieModel.setReflectionOpacity(reflectionOpacity);
+        }
+        return result;
+    }
+
+    /*
+     * Creates a new model of the given 'modelType' or - if 'screenieModel' is given -
+     * updates that model with the model record data in 'dataStream'.
+     */
+    static ScreenieModelInterface *readModelRecord(QDataStream &dataStream, quint8 modelType, const QString &journalPath,
+                                                   ScreenieModelInterface *screenieModel)
+    {
+        ScreenieModelInterface *result;
+        bool ok = false;
+        switch (modelType) {
+        case FilePathModel:
+        {
+            ScreenieFilePathModel *screenieFilePathModel = screenieModel != 0 ? qobject_cast<ScreenieFilePathModel *>(screenieModel)
+                                                                              : new ScreenieFilePathModel();
+            QString filePath;
+            if (screenieFilePathModel != 0 && readProperties(dataStream, *screenieFilePathModel)) {
+                dataStream >> filePath;
+                if (screenieFilePathModel->getFilePath() != filePath) {
+                    screenieFilePathModel->setFilePath(filePath);
+                }
+                ok = true;
+            }
+            result = screenieFilePathModel;
+            break;
+        }
+        case ImageModel:
+        {
+            ScreenieImageModel *screenieImageModel = screenieModel != 0 ? qobject_cast<ScreenieImageModel *>(screenieModel)
+                                                                        : new ScreenieImageModel();
+            QByteArray hash;
+            QSize size;
+            if (screenieImageModel != 0 && readProperties(dataStream, *screenieImageModel)) {
+                dataStream >> hash >> size;
+                QFile imageFile(getImageFilePath(journalPath, hash));
+                if (imageFile.open(QIODevice::ReadOnly)) {
+                    screenieImageModel->setEncodedImage(imageFile.readAll(), size);
+                    ok = true;
+                }
+            }
+            result = screenieImageModel;
+            break;
+        }
+        case TemplateModel:
+        {
+            ScreenieTemplateModel *screenieTemplateModel = screenieModel != 0 ? qobject_cast<ScreenieTemplateModel *>(screenieModel)
+                                                                              : new ScreenieTemplateModel();
+            qint32 order;
+            qint32 fitMode;
+            QBitArray fitOptions;
+            QSize targetSize;
+            if (screenieTemplateModel != 0 && readProperties(dataStream, *screenieTemplateModel)) {
+                SizeFitter &sizeFitter = screenieTemplateModel->getSizeFitter();
+                dataStream >> order >> fitMode >> fitOptions >> targetSize;
+                screenieTemplateModel->setOrder(order);
+                sizeFitter.setFitMode(static_cast<SizeFitter::FitMode>(fitMode));
+                sizeFitter.setFitOptions(fitOptions);
+                sizeFitter.setTargetSize(targetSize);
+                ok = true;
+            }
+            result = screenieTemplateModel;
+            break;
+        }
+        default:
+#ifdef DEBUG
+            qCritical("AutoSaveJournalPrivate::readModelRecord: UNSUPPORTED model type: %d", modelType);
+#endif
+            result = 0;
+            break;
+        }
+        ok = ok && dataStream.status() == QDataStream::Ok;
+        if (!ok) {
+            // only models created here are deleted
+            if (screenieModel == 0) {
+                delete result;
+            }
+            result = 0;
+        }
+        return result;
+    }
+};
+
+const char AutoSaveJournalPrivate::Magic[] = "SCRNJRNL";
+const int AutoSaveJournalPrivate::MagicLength = 8;
+const quint32 AutoSaveJournalPrivate::FormatVersion = 1;
+const QDataStream::Version AutoSaveJournalPrivate::DataStreamVersion = QDataStream::Qt_4_6;
+const int AutoSaveJournalPrivate::FlushDelay = 2000;
+const int AutoSaveJournalPrivate::CompactionThreshold = 256;
+int AutoSaveJournalPrivate::instanceCount = 0;
+
+// public
+
+AutoSaveJournal::AutoSaveJournal(const ScreenieScene &screenieScene, QObject *parent)
+    : QObject(parent),
+      d(new AutoSaveJournalPrivate(screenieScene))
+{
+    QDir().mkpath(AutoSaveJournalPrivate::getImageStorePath(d->journalPath));
+    foreach (const ScreenieModelInterface *screenieModel, d->screenieScene.getModels()) {
+        watch(*screenieModel);
+    }
+    frenchConnection();
+    // the initial journal describes the entire scene
+    scheduleFlush();
+}
+
+AutoSaveJournal::~AutoSaveJournal()
+{
+    d->flushTimer.stop();
+    remove(d->journalPath);
+    delete d;
+}
+
+void AutoSaveJournal::discard()
+{
+    d->flushTimer.stop();
+    remove(d->journalPath);
+    QDir().mkpath(AutoSaveJournalPrivate::getImageStorePath(d->journalPath));
+    d->changedModels.clear();
+    d->removedModelIds.clear();
+    d->imageHashes.clear();
+    d->sceneChanged = false;
+    d->compactionPending = true;
+    d->recordCount = 0;
+}
+
+QStringList AutoSaveJournal::getRecoverableJournals()
+{
+    QStringList result;
+    QDir autoSaveDirectory(AutoSaveJournalPrivate::getAutoSavePath());
+    qint64 applicationPid = QCoreApplication::applicationPid();
+    foreach (const QString &journalName, autoSaveDirectory.entryList(QDir::Dirs | QDir::NoDotAndDotDot)) {
+        bool ok;
+        qint64 pid = journalName.section('-', 0, 0).toLongLong(&ok);
+        if (ok && pid != applicationPid && !AutoSaveJournalPrivate::isRunning(pid)) {
+            QString journalPath = autoSaveDirectory.filePath(journalName);
+            if (QFile::exists(AutoSaveJournalPrivate::getJournalFilePath(journalPath))) {
+                result.append(journalPath);
+            }
+        }
+    }
+    return result;
+}
+
+ScreenieScene *AutoSaveJournal::recover(const QString &journalPath)
+{
+    ScreenieScene *result = 0;
+    QFile file(AutoSaveJournalPrivate::getJournalFilePath(journalPath));
+    if (file.open(QIODevice::ReadOnly)) {
+        QDataStream dataStream(&file);
+        dataStream.setVersion(AutoSaveJournalPrivate::DataStreamVersion);
+        if (AutoSaveJournalPrivate::readHeader(dataStream)) {
+            result = new ScreenieScene();
+            QHash<quint32, ScreenieModelInterface *> screenieModels;
+            while (!dataStream.atEnd()) {
+                QByteArray record;
+                dataStream >> record;
+                if (dataStream.status() != QDataStream::Ok) {
+                    // truncated record: written while crashing
+                    break;
+                }
+                QDataStream recordStream(record);
+                recordStream.setVersion(AutoSaveJournalPrivate::DataStreamVersion);
+                quint8 recordType;
+                recordStream >> recordType;
+                switch (recordType) {
+                case AutoSaveJournalPrivate::SceneRecord:
+                {
+                    bool isTemplate;
+                    bool backgroundEnabled;
+                    QColor backgroundColor;
+                    recordStream >> isTemplate >> backgroundEnabled >> backgroundColor;
+                    if (recordStream.status() == QDataStream::Ok) {
+                        result->setTemplate(isTemplate);
+                        result->setBackgroundEnabled(backgroundEnabled);
+                        result->setBackgroundColor(backgroundColor);
+                    }
+                    break;
+                }
+                case AutoSaveJournalPrivate::ModelRecord:
+                {
+                    quint32 modelId;
+                    quint8 modelType;
+                    recordStream >> modelId >> modelType;
+                    ScreenieModelInterface *screenieModel = screenieModels.value(modelId);
+                    bool isNew = screenieModel == 0;
+                    screenieModel = AutoSaveJournalPrivate::readModelRecord(recordStream, modelType, journalPath, screenieModel);
+                    if (isNew && screenieModel != 0) {
+                        screenieModels.insert(modelId, screenieModel);
+                        result->addModel(screenieModel);
+                    }
+                    break;
+                }
+                case AutoSaveJournalPrivate::RemoveRecord:
+                {
+                    quint32 modelId;
+                    recordStream >> modelId;
+                    ScreenieModelInterface *screenieModel = screenieModels.take(modelId);
+                    if (screenieModel != 0) {
+                        result->removeModel(screenieModel);
+                    }
+                    break;
+                }
+                default:
+#ifdef DEBUG
+                    qCritical("AutoSaveJournal::recover: UNSUPPORTED record type: %d", recordType);
+#endif
+                    break;
+                }
+            }
+            // the recovered changes have not been saved yet
+            result->setModified(true);
+        }
+        file.close();
+    }
+#ifdef DEBUG
+    qDebug("AutoSaveJournal::recover: %s, success: %d", qPrintable(journalPath), result != 0);
+#endif
+    return result;
+}
+
+void AutoSaveJournal::remove(const QString &journalPath)
+{
+    QDir imageStoreDirectory(AutoSaveJournalPrivate::getImageStorePath(journalPath));
+    foreach (const QString &imageFileName, imageStoreDirectory.entryList(QDir::Files)) {
+        imageStoreDirectory.remove(imageFileName);
+    }
+    QDir journalDirectory(journalPath);
+    journalDirectory.rmdir(imageStoreDirectory.absolutePath());
+    foreach (const QString &fileName, journalDirectory.entryList(QDir::Files)) {
+        journalDirectory.remove(fileName);
+    }
+    QDir().rmdir(journalPath);
+}
+
+// private
+
+void AutoSaveJournal::frenchConnection()
+{
+    connect(&d->screenieScene, SIGNAL(modelAdded(ScreenieModelInterface &)),
+            this, SLOT(handleModelAdded(ScreenieModelInterface &)));
+    connect(&d->screenieScene, SIGNAL(modelRemoved(ScreenieModelInterface &)),
+            this, SLOT(handleModelRemoved(ScreenieModelInterface &)));
+    connect(&d->screenieScene, SIGNAL(modelsAdded(const QList<ScreenieModelInterface *> &)),
+            this, SLOT(handleModelsAdded(const QList<ScreenieModelInterface *> &)));
+    connect(&d->screenieScene, SIGNAL(modelsRemoved(const QList<ScreenieModelInterface *> &)),
+            this, SLOT(handleModelsRemoved(const QList<ScreenieModelInterface *> &)));
+    connect(&d->screenieScene, SIGNAL(backgroundChanged()),
+            this, SLOT(handleBackgroundChanged()));
+    connect(&d->flushTimer, SIGNAL(timeout()),
+            this, SLOT(flush()));
+}
+
+void AutoSaveJournal::watch(const ScreenieModelInterface &screenieModel)
+{
+    d->modelIds.insert(&screenieModel, d->nextModelId++);
+    // as with the ScreenieScene the property signals are connected one by one:
+    // models only emit changed() for changes which have no signal of their own
+    connect(&screenieModel, SIGNAL(positionChanged()),
+            this, SLOT(handleModelChanged()));
+    connect(&screenieModel, SIGNAL(distanceChanged()),
+            this, SLOT(handleModelChanged()));
+    connect(&screenieModel, SIGNAL(rotationChanged()),
+            this, SLOT(handleModelChanged()));
+    connect(&screenieModel, SIGNAL(reflectionChanged()),
+            this, SLOT(handleModelChanged()));
+    connect(&screenieModel, SIGNAL(filePathChanged(const QString &)),
+            this, SLOT(handleModelChanged()));
+    connect(&screenieModel, SIGNAL(changed()),
+            this, SLOT(handleModelChanged()));
+    connect(&screenieModel, SIGNAL(imageChanged(const QImage &)),
+            this, SLOT(handleImageChanged()));
+}
+
+void AutoSaveJournal::scheduleFlush()
+{
+    // changes are collected until the journal is flushed
+    if (!d->flushTimer.isActive()) {
+        d->flushTimer.start();
+    }
+}
+
+void AutoSaveJournal::compact()
+{
+    QString journalFilePath = AutoSaveJournalPrivate::getJournalFilePath(d->journalPath);
+    QString temporaryFilePath = journalFilePath + ".compacting";
+    QFile file(temporaryFilePath);
+    bool ok = file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    if (ok) {
+        QDataStream dataStream(&file);
+        dataStream.setVersion(AutoSaveJournalPrivate::DataStreamVersion);
+        AutoSaveJournalPrivate::writeHeader(dataStream);
+        ok = writeSceneRecord(dataStream);
+        foreach (const ScreenieModelInterface *screenieModel, d->screenieScene.getModels()) {
+            ok = ok && writeModelRecord(dataStream, *screenieModel);
+        }
+        ok = ok && dataStream.status() == QDataStream::Ok && file.flush() && AutoSaveJournalPrivate::sync(file);
+        file.close();
+    }
+    ok = ok && FileUtils::replaceFile(temporaryFilePath, journalFilePath);
+    if (ok) {
+        d->changedModels.clear();
+        d->removedModelIds.clear();
+        d->sceneChanged = false;
+        d->compactionPending = false;
+        d->recordCount = 0;
+        removeUnreferencedImages();
+    } else {
+        QFile::remove(temporaryFilePath);
+    }
+#ifdef DEBUG
+    qDebug("AutoSaveJournal::compact: %s, ok: %d", qPrintable(journalFilePath), ok);
+#endif
+}
+
+bool AutoSaveJournal::writeSceneRecord(QDataStream &dataStream)
+{
+    QByteArray record;
+    QDataStream recordStream(&record, QIODevice::WriteOnly);
+    recordStream.setVersion(AutoSaveJournalPrivate::DataStreamVersion);
+    recordStream << static_cast<quint8>(AutoSaveJournalPrivate::SceneRecord);
+    recordStream << d->screenieScene.isTemplate();
+    recordStream << d->screenieScene.isBackgroundEnabled();
+    recordStream << d->screenieScene.getBackgroundColor();
+    dataStream << record;
+    ++d->recordCount;
+    return dataStream.status() == QDataStream::Ok;
+}
+
+bool AutoSaveJournal::writeModelRecord(QDataStream &dataStream, const ScreenieModelInterface &screenieModel)
+{
+    bool result = true;
+    bool supported = true;
+    QByteArray record;
+    QDataStream recordStream(&record, QIODevice::WriteOnly);
+    recordStream.setVersion(AutoSaveJournalPrivate::DataStreamVersion);
+    recordStream << static_cast<quint8>(AutoSaveJournalPrivate::ModelRecord);
+    recordStream << d->modelIds.value(&screenieModel);
+
+    const ScreenieFilePathModel *screenieFilePathModel = qobject_cast<const ScreenieFilePathModel *>(&screenieModel);
+    const ScreenieImageModel *screenieImageModel = qobject_cast<const ScreenieImageModel *>(&screenieModel);
+    const ScreenieTemplateModel *screenieTemplateModel = qobject_cast<const ScreenieTemplateModel *>(&screenieModel);
+    if (screenieFilePathModel != 0) {
+        recordStream << static_cast<quint8>(AutoSaveJournalPrivate::FilePathModel);
+        AutoSaveJournalPrivate::writeProperties(recordStream, screenieModel);
+        recordStream << screenieFilePathModel->getFilePath();
+    } else if (screenieImageModel != 0) {
+        QByteArray hash = storeImage(screenieModel);
+        recordStream << static_cast<quint8>(AutoSaveJournalPrivate::ImageModel);
+        AutoSaveJournalPrivate::writeProperties(recordStream, screenieModel);
+        recordStream << hash << screenieImageModel->getSize();
+        result = !hash.isEmpty();
+    } else if (screenieTemplateModel != 0) {
+        SizeFitter &sizeFitter = screenieTemplateModel->getSizeFitter();
+        recordStream << static_cast<quint8>(AutoSaveJournalPrivate::TemplateModel);
+        AutoSaveJournalPrivate::writeProperties(recordStream, screenieModel);
+        recordStream << static_cast<qint32>(screenieTemplateModel->getOrder());
+        recordStream << static_cast<qint32>(sizeFitter.getFitMode());
+        recordStream << sizeFitter.getFitOptions();
+        recordStream << sizeFitter.getTargetSize();
+    } else {
+#ifdef DEBUG
+        qCritical("AutoSaveJournal::writeModelRecord: UNSUPPORTED: %s", screenieModel.metaObject()->className());
+#endif
+        // unsupported models are not journaled
+        supported = false;
+    }
+    if (result && supported) {
+        dataStream << record;
+        ++d->recordCount;
+        result = dataStream.status() == QDataStream::Ok;
+    }
+    return result;
+}
+
+QByteArray AutoSaveJournal::storeImage(const ScreenieModelInterface &screenieModel)
+{
+    QByteArray result = d->imageHashes.value(&screenieModel);
+    if (result.isNull()) {
+        const ScreenieImageModel &screenieImageModel = static_cast<const ScreenieImageModel &>(screenieModel);
+        QByteArray encodedImage = screenieImageModel.getEncodedImage();
+        result = screenieImageModel.getImageHash();
+        QString imageFilePath = AutoSaveJournalPrivate::getImageFilePath(d->journalPath, result);
+        // each distinct image is only stored once
+        if (!QFile::exists(imageFilePath)) {
+            QString temporaryFilePath = imageFilePath + ".storing";
+            QFile imageFile(temporaryFilePath);
+            // the image must be on disk before any record which refers to it
+            bool ok = imageFile.open(QIODevice::WriteOnly) && imageFile.write(encodedImage) == encodedImage.size() &&
+                      imageFile.flush() && AutoSaveJournalPrivate::sync(imageFile);
+            imageFile.close();
+            ok = ok && FileUtils::replaceFile(temporaryFilePath, imageFilePath);
+            if (!ok) {
+                QFile::remove(temporaryFilePath);
+                result = QByteArray();
+            }
+        }
+        if (!result.isNull()) {
+            d->imageHashes.insert(&screenieModel, result);
+        }
+    }
+    return result;
+}
+
+void AutoSaveJournal::removeUnreferencedImages()
+{
+    QSet<QString> referencedImageFileNames;
+    foreach (const QByteArray &hash, d->imageHashes) {
+        referencedImageFileNames.insert(QString::fromLatin1(hash) + ".png");
+    }
+    QDir imageStoreDirectory(AutoSaveJournalPrivate::getImageStorePath(d->journalPath));
+    foreach (const QString &imageFileName, imageStoreDirectory.entryList(QDir::Files)) {
+        if (!referencedImageFileNames.contains(imageFileName)) {
+            imageStoreDirectory.remove(imageFileName);
+        }
+    }
+}
+
+// private slots
+
+void AutoSaveJournal::handleModelAdded(ScreenieModelInterface &screenieModel)
+{
+    watch(screenieModel);
+    d->changedModels.insert(&screenieModel);
+    scheduleFlush();
+}
+
+void AutoSaveJournal::handleModelRemoved(ScreenieModelInterface &screenieModel)
+{
+    // the model is about to be deleted
+    disconnect(&screenieModel, 0, this, 0);
+    d->changedModels.remove(&screenieModel);
+    d->imageHashes.remove(&screenieModel);
+    d->removedModelIds.append(d->modelIds.take(&screenieModel));
+    scheduleFlush();
+}
+
+void AutoSaveJournal::handleModelsAdded(const QList<ScreenieModelInterface *> &screenieModels)
+{
+    foreach (ScreenieModelInterface *screenieModel, screenieModels) {
+        handleModelAdded(*screenieModel);
+    }
+}
+
+void AutoSaveJournal::handleModelsRemoved(const QList<ScreenieModelInterface *> &screenieModels)
+{
+    foreach (ScreenieModelInterface *screenieModel, screenieModels) {
+        handleModelRemoved(*screenieModel);
+    }
+}
+
+void AutoSaveJournal::handleModelChanged()
+{
+    const ScreenieModelInterface *screenieModel = static_cast<const ScreenieModelInterface *>(sender());
+    d->changedModels.insert(screenieModel);
+    scheduleFlush();
+}
+
+void AutoSaveJournal::handleImageChanged()
+{
+    const ScreenieModelInterface *screenieModel = static_cast<const ScreenieModelInterface *>(sender());
+    d->imageHashes.remove(screenieModel);
+    d->changedModels.insert(screenieModel);
+    scheduleFlush();
+}
+
+void AutoSaveJournal::handleBackgroundChanged()
+{
+    d->sceneChanged = true;
+    scheduleFlush();
+}
+
+void AutoSaveJournal::flush()
+{
+    if (d->compactionPending && !d->screenieScene.isModified()) {
+        // nothing to recover (yet): the first compaction will describe the entire scene
+        d->changedModels.clear();
+        d->removedModelIds.clear();
+        d->sceneChanged = false;
+    } else if (d->compactionPending || d->recordCount >= AutoSaveJournalPrivate::CompactionThreshold) {
+        compact();
+    } else {
+        QFile file(AutoSaveJournalPrivate::getJournalFilePath(d->journalPath));
+        bool ok = file.open(QIODevice::WriteOnly | QIODevice::Append);
+        if (ok) {
+            QDataStream dataStream(&file);
+            dataStream.setVersion(AutoSaveJournalPrivate::DataStreamVersion);
+            foreach (quint32 modelId, d->removedModelIds) {
+                QByteArray record;
+                QDataStream recordStream(&record, QIODevice::WriteOnly);
+                recordStream.setVersion(AutoSaveJournalPrivate::DataStreamVersion);
+                recordStream << static_cast<quint8>(AutoSaveJournalPrivate::RemoveRecord) << modelId;
+                dataStream << record;
+                ++d->recordCount;
+            }
+            if (d->sceneChanged) {
+                ok = writeSceneRecord(dataStream);
+            }
+            // in scene order, so models are recovered in the same order
+            foreach (const ScreenieModelInterface *screenieModel, d->screenieScene.getModels()) {
+                if (d->changedModels.contains(screenieModel)) {
+                    ok = writeModelRecord(dataStream, *screenieModel) && ok;
+                }
+            }
+            ok = ok && dataStream.status() == QDataStream::Ok && file.flush() && AutoSaveJournalPrivate::sync(file);
+            file.close();
+        }
+        d->changedModels.clear();
+        d->removedModelIds.clear();
+        d->sceneChanged = false;
+        // start over with a complete journal if appending failed
+        d->compactionPending = !ok;
+#ifdef DEBUG
+        qDebug("AutoSaveJournal::flush: records: %d, ok: %d", d->recordCount, ok);
+#endif
+    }
+}
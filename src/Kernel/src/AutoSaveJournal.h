@@ -0,0 +1,125 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef AUTOSAVEJOURNAL_H
+#define AUTOSAVEJOURNAL_H
+
+#include <QtCore/QObject>
+#include <QtCore/QStringList>
+
+class QString;
+class QDataStream;
+
+class ScreenieScene;
+class ScreenieModelInterface;
+class AutoSaveJournalPrivate;
+
+#include "KernelLib.h"
+
+/*!
+ * Keeps a crash-safe journal of the changes of a ScreenieScene, from which the
+ * scene can be recovered after a crash. Each batch of records is synced to disk,
+ * so the journal also survives a crash of the operating system, up to the last
+ * completed batch.
+ *
+ * Changes are collected and appended every few seconds as compact records: only
+ * the properties of the models which have actually changed are written. Images
+ * are stored once, by the SHA-1 hash of their encoded data, in a separate image
+ * store. So the cost of autosaving is proportional to what changed, not to the
+ * size of the document.
+ *
+ * From time to time the journal is compacted: it is replaced by a journal which
+ * describes the current scene only, and images which are no longer referenced
+ * are removed from the image store.
+ *
+ * Nothing is journaled as long as the scene is unmodified. The journal is removed
+ * when the AutoSaveJournal is destroyed, that is when the document is closed
+ * regularly. Journals which remain are left by crashed application instances and
+ * can be recovered.
+ *
+ * \sa #getRecoverableJournals()
+ */
+class AutoSaveJournal : public QObject
+{
+    Q_OBJECT
+public:
+    /*!
+     * Creates this AutoSaveJournal which journals the changes of the \p screenieScene.
+     * The AutoSaveJournal must be destroyed before the \p screenieScene.
+     */
+    KERNEL_API explicit AutoSaveJournal(const ScreenieScene &screenieScene, QObject *parent = 0);
+
+    /*!
+     * Removes the journal.
+     */
+    KERNEL_API virtual ~AutoSaveJournal();
+
+    /*!
+     * Discards the journal, for instance after the scene has been saved. Journaling
+     * starts over once the scene is modified again.
+     */
+    KERNEL_API void discard();
+
+    /*!
+     * Returns the journals left by application instances which are no longer running.
+     * Journals of instances which are not known to have terminated are never returned.
+     *
+     * \return the paths of the recoverable journals
+     */
+    KERNEL_API static QStringList getRecoverableJournals();
+
+    /*!
+     * Recovers the ScreenieScene by replaying the journal at \p journalPath. A
+     * truncated last record - as caused by a crash while writing - is ignored.
+     *
+     * \return the recovered ScreenieScene which must be \c deleted by the caller;
+     *         0 if the journal could not be read
+     */
+    KERNEL_API static ScreenieScene *recover(const QString &journalPath);
+
+    /*!
+     * Removes the journal at \p journalPath, including its image store.
+     */
+    KERNEL_API static void remove(const QString &journalPath);
+
+private:
+    AutoSaveJournalPrivate *d;
+
+    void frenchConnection();
+    void watch(const ScreenieModelInterface &screenieModel);
+    void scheduleFlush();
+    void compact();
+    bool writeSceneRecord(QDataStream &dataStream);
+    bool writeModelRecord(QDataStream &dataStream, const ScreenieModelInterface &screenieModel);
+    QByteArray storeImage(const ScreenieModelInterface &screenieModel);
+    void removeUnreferencedImages();
+
+private slots:
+    void handleModelAdded(ScreenieModelInterface &screenieModel);
+    void handleModelRemoved(ScreenieModelInterface &screenieModel);
+    void handleModelsAdded(const QList<ScreenieModelInterface *> &screenieModels);
+    void handleModelsRemoved(const QList<ScreenieModelInterface *> &screenieModels);
+    void handleModelChanged();
+    void handleImageChanged();
+    void handleBackgroundChanged();
+    void flush();
+};
+
+#endif // AUTOSAVEJOURNAL_H
@@ -32,10 +32,11 @@
 #include "../../../Model/src/ScreenieModelInterface.h"
 #include "../../../Model/src/Dao/ScreenieSceneSerializer.h"
 #include "../../../Model/src/Dao/Xml/XmlScreenieSceneSerializer.h"
-#include "../ExportImage.h"
+#include "../../../Model/src/Dao/Package/PackageScreenieSceneSerializer.h"
 #include "../ScreenieControl.h"
 #include "../ScreenieGraphicsScene.h"
 #include "MimeHelper.h"
+#include "SharedMemoryTransfer.h"
 #include "ScreenieMimeData.h"
 #include "Clipboard.h"
 
@@ -43,12 +44,10 @@ class ClipboardPrivate
 {
 public:
     ClipboardPrivate(ScreenieControl &control)
-        : screenieControl(control),
-          exportImage(control.getScreenieScene(), control.getScreenieGraphicsScene())
+        : screenieControl(control)
     {}
 
     ScreenieControl &screenieControl;
-    ExportImage exportImage;
 };
 
 // public
@@ -82,10 +81,8 @@ bool Clipboard::hasData() const
 void Clipboard::cut()
 {
     storeMimeData();
-    QList<ScreenieModelInterface *> selectedItems = d->screenieControl.getScreenieScene().getSelectedModels();
-    foreach (ScreenieModelInterface *selectedItem, selectedItems) {
-        d->screenieControl.getScreenieScene().removeModel(selectedItem);
-    }    
+    ScreenieScene &screenieScene = d->screenieControl.getScreenieScene();
+    screenieScene.removeModels(screenieScene.getSelectedModels());
 }
 
 void Clipboard::copy()
@@ -104,28 +101,34 @@ void Clipboard::paste()
 #endif
 
     if (MimeHelper::accept(mimeData, MimeHelper::Relaxed)) {
+        ScreenieScene &screenieScene = d->screenieControl.getScreenieScene();
+        screenieScene.beginUpdate();
         // in order of preference
         const ScreenieMimeData *screenieMimeData = qobject_cast<const ScreenieMimeData *>(mimeData);
         if (screenieMimeData != 0) {
             // inside the same application instance
-            const QList<const ScreenieModelInterface *> copies = screenieMimeData->getScreenieModels();
-            foreach (const ScreenieModelInterface *clipboardModel, copies) {
-                ScreenieModelInterface *copy = clipboardModel->copy();
-                d->screenieControl.getScreenieScene().addModel(copy);
+            QList<ScreenieModelInterface *> copies;
+            foreach (const ScreenieModelInterface *clipboardModel, screenieMimeData->getScreenieModels()) {
+                copies.append(clipboardModel->copy());
             }
-        } else if (mimeData->hasFormat(MimeHelper::ScreenieMimeType)) {
-            // across application instance boundaries
-            ScreenieSceneSerializer *screenieSceneSerializer = new XmlScreenieSceneSerializer();
-            QByteArray data = mimeData->data(MimeHelper::ScreenieMimeType);
-            ScreenieScene *clipboardScreenieScene = screenieSceneSerializer->deserialize(data);
-            if (clipboardScreenieScene != 0) {
-                const QList<ScreenieModelInterface *> copies = clipboardScreenieScene->getModels();
-                foreach (const ScreenieModelInterface *clipboardModel, copies) {
-                    ScreenieModelInterface *copy = clipboardModel->copy();
-                    d->screenieControl.getScreenieScene().addModel(copy);
-                }
-                delete clipboardScreenieScene;
+            screenieScene.addModels(copies);
+        } else if (mimeData->hasFormat(MimeHelper::ScreeniePackageMimeType)) {
+            // across application instance boundaries, binary: the data is read directly
+            // from the shared memory of the other instance, if still available
+            PackageScreenieSceneSerializer packageScreenieSceneSerializer;
+            SharedMemoryTransfer sharedMemoryTransfer;
+            QByteArray data;
+            if (mimeData->hasFormat(MimeHelper::ScreenieSharedMemoryMimeType) &&
+                sharedMemoryTransfer.attach(mimeData->data(MimeHelper::ScreenieSharedMemoryMimeType))) {
+                data = sharedMemoryTransfer.getData();
+            } else {
+                data = mimeData->data(MimeHelper::ScreeniePackageMimeType);
             }
+            addModels(packageScreenieSceneSerializer, data);
+        } else if (mimeData->hasFormat(MimeHelper::ScreenieMimeType)) {
+            // across application instance boundaries, from older versions
+            XmlScreenieSceneSerializer xmlScreenieSceneSerializer;
+            addModels(xmlScreenieSceneSerializer, mimeData->data(MimeHelper::ScreenieMimeType));
         } else if (mimeData->hasImage()) {
             // from different image application
             QImage image = qvariant_cast<QImage>(mimeData->imageData());
@@ -140,6 +143,7 @@ void Clipboard::paste()
                 }
             }
         }
+        screenieScene.endUpdate();
     }
 }
 
@@ -152,6 +156,16 @@ void Clipboard::frenchConnection()
             this, SIGNAL(dataChanged()));
 }
 
+void Clipboard::addModels(const ScreenieSceneSerializer &screenieSceneSerializer, QByteArray data)
+{
+    ScreenieScene *clipboardScreenieScene = screenieSceneSerializer.deserialize(data);
+    if (clipboardScreenieScene != 0) {
+        // the deserialized models are not needed otherwise: no copies
+        d->screenieControl.getScreenieScene().addModels(clipboardScreenieScene->takeModels());
+        delete clipboardScreenieScene;
+    }
+}
+
 void Clipboard::storeMimeData()
 {
     QList<const ScreenieModelInterface *> copies;
@@ -161,15 +175,10 @@ void Clipboard::storeMimeData()
     }
     if (copies.count() > 0) {
         QClipboard *clipboard = QApplication::clipboard();
+        // the image and the serialized XML data are only created when requested
         ScreenieMimeData *screenieMimeData = new ScreenieMimeData(copies);
-        // Image data
-        QImage image = d->exportImage.exportImage(ExportImage::Selected);
-        screenieMimeData->setImageData(image);
-        ScreenieSceneSerializer *screenieSceneSerializer = new XmlScreenieSceneSerializer();
-        // Serialized XML data
-        QByteArray data = screenieSceneSerializer->serialize(d->screenieControl.getScreenieScene(), ScreenieSceneSerializer::SelectedItems);
-        screenieMimeData->setData(MimeHelper::ScreenieMimeType, data);
-        screenieMimeData->setData(MimeHelper::XmlMimeType, data);
+        const ScreenieScene &screenieScene = d->screenieControl.getScreenieScene();
+        screenieMimeData->setBackground(screenieScene.isBackgroundEnabled(), screenieScene.getBackgroundColor());
         clipboard->setMimeData(screenieMimeData);
     }
 }
@@ -24,11 +24,13 @@
 #include <QtCore/QObject>
 
 class QGraphicsScene;
+class QByteArray;
 
 #include "../KernelLib.h"
 
 class ScreenieControl;
 class ScreenieModelInterface;
+class ScreenieSceneSerializer;
 class ClipboardPrivate;
 
 /*!
@@ -61,6 +63,7 @@ private:
     ClipboardPrivate *d;
 
     void frenchConnection();
+    void addModels(const ScreenieSceneSerializer &screenieSceneSerializer, QByteArray data);
     void storeMimeData();
 };
 
@@ -33,6 +33,8 @@
 // public
 
 const QString MimeHelper::ScreenieMimeType = QString("application/x-") + Version::getApplicationName().toLower();
+const QString MimeHelper::ScreeniePackageMimeType = MimeHelper::ScreenieMimeType + QString("-package");
+const QString MimeHelper::ScreenieSharedMemoryMimeType = MimeHelper::ScreenieMimeType + QString("-shm");
 const QString MimeHelper::XmlMimeType = QString("text/xml");
 const QString MimeHelper::TextMimeType = QString("text/plain");
 
@@ -36,6 +36,23 @@ public:
      */
     static const QString ScreenieMimeType;
 
+    /*!
+     * The MIME type for the application data in the binary package format, which
+     * is preferred over the XML data of the ScreenieMimeType.
+     *
+     * \sa PackageScreenieSceneSerializer
+     */
+    static const QString ScreeniePackageMimeType;
+
+    /*!
+     * The MIME type for the handle of a shared memory segment which contains the
+     * application data in the binary package format, with uncompressed images. Preferred
+     * over the ScreeniePackageMimeType, as long as the segment is available.
+     *
+     * \sa SharedMemoryTransfer
+     */
+    static const QString ScreenieSharedMemoryMimeType;
+
     /*!
      * The MIME type for generic XML data: 'text/xml'
      */
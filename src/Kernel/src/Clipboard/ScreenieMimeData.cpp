@@ -20,20 +20,50 @@
 
 #include <QtCore/QtAlgorithms>
 #include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/QStringList>
+#include <QtCore/QByteArray>
+#include <QtCore/QVariant>
+#include <QtGui/QColor>
+#include <QtGui/QImage>
 
+#include "../../../Model/src/ScreenieScene.h"
 #include "../../../Model/src/ScreenieModelInterface.h"
+#include "../../../Model/src/Dao/ScreenieSceneSerializer.h"
+#include "../../../Model/src/Dao/Xml/XmlScreenieSceneSerializer.h"
+#include "../../../Model/src/Dao/Package/PackageScreenieSceneSerializer.h"
+#include "../ExportImage.h"
+#include "../ScreenieControl.h"
+#include "../ScreenieGraphicsScene.h"
+#include "MimeHelper.h"
+#include "SharedMemoryTransfer.h"
 #include "ScreenieMimeData.h"
 
 class ScreenieMimeDataPrivate
 {
 public:
+    // the MIME type under which QMimeData provides QImage data
+    static const QString ImageMimeType;
+
     ScreenieMimeDataPrivate(QList<const ScreenieModelInterface *> models)
-        : screenieModels(models)
+        : screenieModels(models),
+          backgroundEnabled(false)
     {}
 
     QList<const ScreenieModelInterface *> screenieModels;
+    bool backgroundEnabled;
+    QColor backgroundColor;
+    // created on demand
+    QByteArray serializedData;
+    QByteArray packageData;
+    // the segment is kept alive as long as this MIME data exists
+    SharedMemoryTransfer sharedMemoryTransfer;
+    QByteArray sharedMemoryHandle;
+    QImage image;
 };
 
+const QString ScreenieMimeDataPrivate::ImageMimeType = QString("application/x-qt-image");
+
 // public
 
 ScreenieMimeData::ScreenieMimeData()
@@ -66,3 +96,107 @@ bool ScreenieMimeData::hasScreenieModels() const
 {
     return d->screenieModels.size() > 0;
 }
+
+void ScreenieMimeData::setBackground(bool enabled, const QColor &color)
+{
+    d->backgroundEnabled = enabled;
+    d->backgroundColor = color;
+    d->image = QImage();
+}
+
+QStringList ScreenieMimeData::formats() const
+{
+    QStringList result = QMimeData::formats();
+    if (hasScreenieModels()) {
+        // in order of preference
+        result << MimeHelper::ScreenieSharedMemoryMimeType << MimeHelper::ScreeniePackageMimeType << MimeHelper::ScreenieMimeType << MimeHelper::XmlMimeType << ScreenieMimeDataPrivate::ImageMimeType;
+    }
+    return result;
+}
+
+bool ScreenieMimeData::hasFormat(const QString &mimeType) const
+{
+    return formats().contains(mimeType);
+}
+
+// protected
+
+QVariant ScreenieMimeData::retrieveData(const QString &mimeType, QVariant::Type type) const
+{
+    QVariant result;
+    if (hasScreenieModels() && mimeType == MimeHelper::ScreenieSharedMemoryMimeType) {
+        if (d->sharedMemoryHandle.isNull()) {
+            // the images are not encoded at all: the receiver copies the pixels right out of the segment
+            PackageScreenieSceneSerializer packageScreenieSceneSerializer(PackageScreenieSceneDao::UncompressedEncoding);
+            QByteArray handle = d->sharedMemoryTransfer.share(serialize(packageScreenieSceneSerializer));
+            // an empty handle is not attachable, so receivers fall back to the other formats
+            d->sharedMemoryHandle = handle.isNull() ? QByteArray("") : handle;
+        }
+        result = d->sharedMemoryHandle;
+    } else if (hasScreenieModels() && mimeType == MimeHelper::ScreeniePackageMimeType) {
+        if (d->packageData.isNull()) {
+            PackageScreenieSceneSerializer packageScreenieSceneSerializer;
+            d->packageData = serialize(packageScreenieSceneSerializer);
+        }
+        result = d->packageData;
+    } else if (hasScreenieModels() && (mimeType == MimeHelper::ScreenieMimeType || mimeType == MimeHelper::XmlMimeType)) {
+        if (d->serializedData.isNull()) {
+            XmlScreenieSceneSerializer xmlScreenieSceneSerializer;
+            d->serializedData = serialize(xmlScreenieSceneSerializer);
+        }
+        result = d->serializedData;
+    } else if (hasScreenieModels() && mimeType == ScreenieMimeDataPrivate::ImageMimeType) {
+        if (d->image.isNull()) {
+            d->image = render();
+        }
+        result = d->image;
+    } else {
+        result = QMimeData::retrieveData(mimeType, type);
+    }
+#ifdef DEBUG
+    qDebug("ScreenieMimeData::retrieveData: %s, type: %d", qPrintable(mimeType), type);
+#endif
+    return result;
+}
+
+// private
+
+ScreenieScene *ScreenieMimeData::createScreenieScene() const
+{
+    ScreenieScene *result = new ScreenieScene();
+    result->setBackgroundEnabled(d->backgroundEnabled);
+    result->setBackgroundColor(d->backgroundColor);
+    return result;
+}
+
+QByteArray ScreenieMimeData::serialize(ScreenieSceneSerializer &screenieSceneSerializer) const
+{
+    QByteArray result;
+    ScreenieScene *screenieScene = createScreenieScene();
+    foreach (const ScreenieModelInterface *screenieModel, d->screenieModels) {
+        ScreenieModelInterface *copy = screenieModel->copy();
+        copy->setSelected(true);
+        screenieScene->addModel(copy);
+    }
+    result = screenieSceneSerializer.serialize(*screenieScene, ScreenieSceneSerializer::SelectedItems);
+    delete screenieScene;
+    return result;
+}
+
+QImage ScreenieMimeData::render() const
+{
+    QImage result;
+    ScreenieScene *screenieScene = createScreenieScene();
+    {
+        // the graphics items are created by the control as the models are added
+        ScreenieGraphicsScene screenieGraphicsScene;
+        ScreenieControl screenieControl(*screenieScene, screenieGraphicsScene);
+        foreach (const ScreenieModelInterface *screenieModel, d->screenieModels) {
+            screenieScene->addModel(screenieModel->copy());
+        }
+        ExportImage exportImage(*screenieScene, screenieGraphicsScene);
+        result = exportImage.exportImage(ExportImage::Scene);
+    }
+    delete screenieScene;
+    return result;
+}
@@ -23,10 +23,24 @@
 
 #include <QtCore/QMimeData>
 #include <QtCore/QList>
+#include <QtCore/QStringList>
+#include <QtCore/QVariant>
 
+class QColor;
+class QImage;
+
+class ScreenieScene;
+class ScreenieSceneSerializer;
 class ScreenieModelInterface;
 class ScreenieMimeDataPrivate;
 
+/*!
+ * The MIME data of copied ScreenieModelInterface instances. Besides the instances
+ * themselves this ScreenieMimeData provides the serialized models (MimeHelper#ScreeniePackageMimeType,
+ * MimeHelper#ScreenieMimeType, MimeHelper#XmlMimeType) and a rendered image of them. These formats are only
+ * created once they are requested by a consumer, typically when pasting into another
+ * application instance, and then cached.
+ */
 class ScreenieMimeData : public QMimeData
 {
     Q_OBJECT
@@ -56,8 +70,24 @@ public:
 
     bool hasScreenieModels() const;
 
+    /*!
+     * Sets the background with which the image of the models is rendered, as
+     * in the ScreenieScene the models have been copied from.
+     */
+    void setBackground(bool enabled, const QColor &color);
+
+    virtual QStringList formats() const;
+    virtual bool hasFormat(const QString &mimeType) const;
+
+protected:
+    virtual QVariant retrieveData(const QString &mimeType, QVariant::Type type) const;
+
 private:
     ScreenieMimeDataPrivate *d;
+
+    ScreenieScene *createScreenieScene() const;
+    QByteArray serialize(ScreenieSceneSerializer &screenieSceneSerializer) const;
+    QImage render() const;
 };
 
 #endif // SCREENIEMIMEDATA_H
@@ -0,0 +1,127 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <cstring>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QSharedMemory>
+#include <QtCore/QDataStream>
+#include <QtCore/QCoreApplication>
+
+#include "../../../Utils/src/Version.h"
+#include "SharedMemoryTransfer.h"
+
+class SharedMemoryTransferPrivate
+{
+public:
+    static const quint32 HandleMagic;
+    static const QDataStream::Version DataStreamVersion;
+    // makes the keys unique within this process
+    static int keyCounter;
+
+    SharedMemoryTransferPrivate()
+        : size(0)
+    {}
+
+    QSharedMemory sharedMemory;
+    // the size of the shared data, which may be smaller than the segment
+    int size;
+};
+
+const quint32 SharedMemoryTransferPrivate::HandleMagic = 0x53484d31; // "SHM1"
+const QDataStream::Version SharedMemoryTransferPrivate::DataStreamVersion = QDataStream::Qt_4_6;
+int SharedMemoryTransferPrivate::keyCounter = 0;
+
+// public
+
+SharedMemoryTransfer::SharedMemoryTransfer()
+    : d(new SharedMemoryTransferPrivate())
+{
+}
+
+SharedMemoryTransfer::~SharedMemoryTransfer()
+{
+    if (d->sharedMemory.isAttached()) {
+        d->sharedMemory.detach();
+    }
+    delete d;
+}
+
+QByteArray SharedMemoryTransfer::share(const QByteArray &data)
+{
+    QByteArray result;
+    QString key = QString("%1-%2-%3").arg(Version::getApplicationName())
+                                     .arg(QCoreApplication::applicationPid())
+                                     .arg(++SharedMemoryTransferPrivate::keyCounter);
+    d->sharedMemory.setKey(key);
+    if (!data.isEmpty() && d->sharedMemory.create(data.size())) {
+        // the data is written once, before the handle is published: readers need not lock
+        d->sharedMemory.lock();
+        std::memcpy(d->sharedMemory.data(), data.constData(), data.size());
+        d->sharedMemory.unlock();
+        d->size = data.size();
+        QDataStream dataStream(&result, QIODevice::WriteOnly);
+        dataStream.setVersion(SharedMemoryTransferPrivate::DataStreamVersion);
+        dataStream << SharedMemoryTransferPrivate::HandleMagic << key << static_cast<qint32>(d->size);
+    } else {
+#ifdef DEBUG
+        qCritical("SharedMemoryTransfer::share: could not create segment %s: %s", qPrintable(key), qPrintable(d->sharedMemory.errorString()));
+#endif
+    }
+    return result;
+}
+
+bool SharedMemoryTransfer::attach(const QByteArray &handle)
+{
+    bool result;
+    quint32 magic;
+    QString key;
+    qint32 size;
+    QDataStream dataStream(handle);
+    dataStream.setVersion(SharedMemoryTransferPrivate::DataStreamVersion);
+    dataStream >> magic >> key >> size;
+    if (dataStream.status() == QDataStream::Ok && magic == SharedMemoryTransferPrivate::HandleMagic && !key.isEmpty() && size > 0) {
+        d->sharedMemory.setKey(key);
+        result = d->sharedMemory.attach(QSharedMemory::ReadOnly);
+        if (result && d->sharedMemory.size() < size) {
+            d->sharedMemory.detach();
+            result = false;
+        }
+        d->size = result ? size : 0;
+    } else {
+        result = false;
+    }
+#ifdef DEBUG
+    if (!result) {
+        qDebug("SharedMemoryTransfer::attach: segment %s not available: %s", qPrintable(key), qPrintable(d->sharedMemory.errorString()));
+    }
+#endif
+    return result;
+}
+
+QByteArray SharedMemoryTransfer::getData() const
+{
+    QByteArray result;
+    if (d->sharedMemory.isAttached()) {
+        result = QByteArray::fromRawData(static_cast<const char *>(d->sharedMemory.constData()), d->size);
+    }
+    return result;
+}
@@ -0,0 +1,79 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef SHAREDMEMORYTRANSFER_H
+#define SHAREDMEMORYTRANSFER_H
+
+#include <QtCore/QByteArray>
+
+class SharedMemoryTransferPrivate;
+
+/*!
+ * Transfers data between application instances through shared memory: the
+ * sending instance places the data into a QSharedMemory segment and only passes
+ * a small \em handle, for instance as MIME data. The receiving instance attaches
+ * to the segment and accesses the data in place.
+ *
+ * The segment exists as long as any instance is attached to it: the sending
+ * SharedMemoryTransfer keeps it alive until it is destroyed, receivers only
+ * while they access the data. Once the sender is gone #attach(const QByteArray &)
+ * fails and the receiver has to fall back to another transport.
+ */
+class SharedMemoryTransfer
+{
+public:
+    SharedMemoryTransfer();
+
+    /*!
+     * Detaches from the segment. The segment is destroyed when the last instance
+     * has detached.
+     */
+    ~SharedMemoryTransfer();
+
+    /*!
+     * Places a copy of the \p data into a new shared memory segment.
+     *
+     * \return the handle which identifies the segment; a null QByteArray on error
+     */
+    QByteArray share(const QByteArray &data);
+
+    /*!
+     * Attaches read-only to the segment identified by \p handle, as returned by
+     * #share(const QByteArray &) in another instance.
+     *
+     * \return \c true if the segment is available; \c false else
+     * \sa #getData()
+     */
+    bool attach(const QByteArray &handle);
+
+    /*!
+     * Returns the shared data. The data is \em not copied: it is only valid as long as
+     * this SharedMemoryTransfer remains attached.
+     *
+     * \return the shared data; a null QByteArray if not attached
+     */
+    QByteArray getData() const;
+
+private:
+    Q_DISABLE_COPY(SharedMemoryTransfer)
+    SharedMemoryTransferPrivate *d;
+};
+
+#endif // SHAREDMEMORYTRANSFER_H
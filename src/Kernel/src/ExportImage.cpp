@@ -21,29 +21,38 @@
 #include <QtCore/QRectF>
 #include <QtCore/QPointF>
 #include <QtCore/QSizeF>
+#include <QtCore/QSize>
+#include <QtCore/QList>
 #include <QtGui/QGraphicsScene>
 #include <QtGui/QGraphicsItem>
 #include <QtGui/QImage>
 #include <QtGui/QPainter>
 
 #include "../../Model/src/ScreenieScene.h"
+#include "../../Model/src/ScreenieModelInterface.h"
+#include "../../Model/src/ScreenieImageModel.h"
+#include "ScreenieGraphicsScene.h"
 #include "ExportImage.h"
 
 class ExportImagePrivate
 {
 public:
-    ExportImagePrivate(const ScreenieScene &theScreenieScene, QGraphicsScene &theGraphicsScene)
+    ExportImagePrivate(const ScreenieScene &theScreenieScene, ScreenieGraphicsScene &theGraphicsScene)
         : screenieScene(theScreenieScene),
           graphicsScene(theGraphicsScene)
     {}
 
+    static const QSize PreviewSize;
+
     const ScreenieScene &screenieScene;
-    QGraphicsScene &graphicsScene;
+    ScreenieGraphicsScene &graphicsScene;
 };
 
+const QSize ExportImagePrivate::PreviewSize = QSize(160, 160);
+
 // public
 
-ExportImage::ExportImage(const ScreenieScene &screenieScene, QGraphicsScene &graphicsScene)
+ExportImage::ExportImage(const ScreenieScene &screenieScene, ScreenieGraphicsScene &graphicsScene)
     : d(new ExportImagePrivate(screenieScene, graphicsScene))
 {
 }
@@ -61,6 +70,38 @@ bool ExportImage::exportImage(const QString &filePath, Selection selection) cons
 }
 
 QImage ExportImage::exportImage(Selection selection) const
+{
+    readImages();
+    return exportImage(selection, QSize());
+}
+
+QImage ExportImage::exportPreview() const
+{
+    return exportImage(Scene, ExportImagePrivate::PreviewSize);
+}
+
+// private
+
+void ExportImage::readImages() const
+{
+    // make sure the actual images are rendered, and not their placeholders: the
+    // images are read here and the items apply them as soon as the scene is about
+    // to be rendered
+    QList<ScreenieImageModel *> screenieImageModels;
+    foreach (ScreenieModelInterface *screenieModel, d->screenieScene.getModels()) {
+        ScreenieImageModel *screenieImageModel = qobject_cast<ScreenieImageModel *>(screenieModel);
+        if (screenieImageModel != 0) {
+            screenieImageModels.append(screenieImageModel);
+        }
+    }
+    // embedded images are decoded concurrently, the remaining ones are read one by one
+    ScreenieImageModel::readImages(screenieImageModels);
+    foreach (ScreenieModelInterface *screenieModel, d->screenieScene.getModels()) {
+        screenieModel->readImage();
+    }
+}
+
+QImage ExportImage::exportImage(Selection selection, const QSize &maximumSize) const
 {
     QRectF sourceRect;
     QBrush oldBackgroundBrush;
@@ -89,7 +130,12 @@ QImage ExportImage::exportImage(Selection selection) const
         sourceRect = d->graphicsScene.itemsBoundingRect();
         break;
     }
-    QImage result(qRound(sourceRect.width()), qRound(sourceRect.height()), QImage::Format_ARGB32);
+    QSize imageSize(qRound(sourceRect.width()), qRound(sourceRect.height()));
+    if (maximumSize.isValid() && (imageSize.width() > maximumSize.width() || imageSize.height() > maximumSize.height())) {
+        // the scene is rendered scaled down right away
+        imageSize.scale(maximumSize, Qt::KeepAspectRatio);
+    }
+    QImage result(imageSize, QImage::Format_ARGB32);
     result.fill(0);
     QPainter painter(&result);
     painter.setRenderHints(QPainter::SmoothPixmapTransform | QPainter::Antialiasing | QPainter::TextAntialiasing, true);
@@ -101,6 +147,8 @@ QImage ExportImage::exportImage(Selection selection) const
         d->graphicsScene.setBackgroundBrush(transparent);
     }
     d->graphicsScene.clearSelection();
+    // the items are collected before the background is painted: they must be up to date by now
+    d->graphicsScene.prepareRender(sourceRect);
     d->graphicsScene.render(&painter, QRectF(), sourceRect);
     // restore selection
     foreach(QGraphicsItem *current, selectedItems) {
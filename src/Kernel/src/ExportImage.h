@@ -23,12 +23,13 @@
 
 #include <QtGui/QImage>
 
-class QGraphicsScene;
 class QString;
+class QSize;
 
 #include "KernelLib.h"
 
 class ScreenieScene;
+class ScreenieGraphicsScene;
 class ExportImagePrivate;
 
 /*!
@@ -42,14 +43,28 @@ public:
         Selected
     };
 
-    KERNEL_API ExportImage(const ScreenieScene &screenieScene, QGraphicsScene &graphicsScene);
+    KERNEL_API ExportImage(const ScreenieScene &screenieScene, ScreenieGraphicsScene &graphicsScene);
     KERNEL_API ~ExportImage();
 
     KERNEL_API bool exportImage(const QString &filePath, Selection selection = Scene) const;
     KERNEL_API QImage exportImage(Selection selection) const;
 
+    /*!
+     * Renders a small preview of the entire scene, which fits into 160 x 160 pixels.
+     * The scene is rendered at the preview size directly, with the pixmaps the items
+     * currently have: images which have not been read yet are not waited for, but
+     * rendered as their placeholders. So the preview is cheap enough to be rendered
+     * each time the scene is saved.
+     *
+     * \sa ScreenieSceneDao#setPreview(const QImage &)
+     */
+    KERNEL_API QImage exportPreview() const;
+
 private:
     ExportImagePrivate *d;
+
+    void readImages() const;
+    QImage exportImage(Selection selection, const QSize &maximumSize) const;
 };
 
 #endif // EXPORTIMAGE_H
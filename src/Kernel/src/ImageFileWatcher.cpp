@@ -0,0 +1,241 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
+#include <QtCore/QTimer>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QFileSystemWatcher>
+
+#include "../../Model/src/ScreenieScene.h"
+#include "../../Model/src/ScreenieModelInterface.h"
+#include "../../Model/src/ScreenieFilePathModel.h"
+#include "ImageFileWatcher.h"
+
+class ImageFileWatcherPrivate
+{
+public:
+    ImageFileWatcherPrivate(const ScreenieScene &theScreenieScene)
+        : screenieScene(theScreenieScene)
+    {
+        debounceTimer.setSingleShot(true);
+        debounceTimer.setInterval(DebounceDelay);
+    }
+
+    const ScreenieScene &screenieScene;
+    QFileSystemWatcher fileSystemWatcher;
+    // absolute file path -> the models which refer to it
+    QHash<QString, QList<ScreenieFilePathModel *> > watchedModels;
+    // model -> the absolute file path it is watched for
+    QHash<ScreenieFilePathModel *, QString> watchedFilePaths;
+    QSet<QString> changedFilePaths;
+    // files which are currently not existing, watched via their directory
+    QSet<QString> missingFilePaths;
+    QTimer debounceTimer;
+
+    static const int DebounceDelay;
+};
+
+// the delay in milliseconds after the last modification, before the
+// modified files are reloaded
+const int ImageFileWatcherPrivate::DebounceDelay = 300;
+
+// public
+
+ImageFileWatcher::ImageFileWatcher(const ScreenieScene &screenieScene)
+    : d(new ImageFileWatcherPrivate(screenieScene))
+{
+    foreach (ScreenieModelInterface *screenieModel, screenieScene.getModels()) {
+        handleModelAdded(*screenieModel);
+    }
+
+    frenchConnection();
+}
+
+ImageFileWatcher::~ImageFileWatcher()
+{
+    delete d;
+}
+
+// private
+
+void ImageFileWatcher::frenchConnection()
+{
+    connect(&d->screenieScene, SIGNAL(modelAdded(ScreenieModelInterface &)),
+            this, SLOT(handleModelAdded(ScreenieModelInterface &)));
+    connect(&d->screenieScene, SIGNAL(modelRemoved(ScreenieModelInterface &)),
+            this, SLOT(handleModelRemoved(ScreenieModelInterface &)));
+    connect(&d->screenieScene, SIGNAL(modelsAdded(const QList<ScreenieModelInterface *> &)),
+            this, SLOT(handleModelsAdded(const QList<ScreenieModelInterface *> &)));
+    connect(&d->screenieScene, SIGNAL(modelsRemoved(const QList<ScreenieModelInterface *> &)),
+            this, SLOT(handleModelsRemoved(const QList<ScreenieModelInterface *> &)));
+    connect(&d->fileSystemWatcher, SIGNAL(fileChanged(const QString &)),
+            this, SLOT(handleFileChanged(const QString &)));
+    connect(&d->fileSystemWatcher, SIGNAL(directoryChanged(const QString &)),
+            this, SLOT(handleDirectoryChanged(const QString &)));
+    connect(&d->debounceTimer, SIGNAL(timeout()),
+            this, SLOT(reloadChangedFiles()));
+}
+
+void ImageFileWatcher::watch(ScreenieModelInterface &screenieModel)
+{
+    ScreenieFilePathModel *screenieFilePathModel = qobject_cast<ScreenieFilePathModel *>(&screenieModel);
+    if (screenieFilePathModel != 0) {
+        // models may be added again to the scene: connect only once
+        connect(screenieFilePathModel, SIGNAL(filePathChanged(const QString &)),
+                this, SLOT(handleFilePathChanged()), Qt::UniqueConnection);
+    }
+    if (screenieFilePathModel != 0 && !screenieFilePathModel->getFilePath().isEmpty()
+        && !d->watchedFilePaths.contains(screenieFilePathModel)) {
+        QString filePath = QFileInfo(screenieFilePathModel->getFilePath()).absoluteFilePath();
+        QList<ScreenieFilePathModel *> &models = d->watchedModels[filePath];
+        if (models.isEmpty()) {
+            watchFile(filePath);
+        }
+        models.append(screenieFilePathModel);
+        d->watchedFilePaths.insert(screenieFilePathModel, filePath);
+    }
+}
+
+void ImageFileWatcher::unwatch(ScreenieModelInterface &screenieModel)
+{
+    ScreenieFilePathModel *screenieFilePathModel = qobject_cast<ScreenieFilePathModel *>(&screenieModel);
+    if (screenieFilePathModel != 0) {
+        disconnect(screenieFilePathModel, SIGNAL(filePathChanged(const QString &)),
+                   this, SLOT(handleFilePathChanged()));
+    }
+    if (screenieFilePathModel != 0 && d->watchedFilePaths.contains(screenieFilePathModel)) {
+        QString filePath = d->watchedFilePaths.take(screenieFilePathModel);
+        QList<ScreenieFilePathModel *> &models = d->watchedModels[filePath];
+        models.removeOne(screenieFilePathModel);
+        if (models.isEmpty()) {
+            d->watchedModels.remove(filePath);
+            d->changedFilePaths.remove(filePath);
+            if (d->missingFilePaths.remove(filePath)) {
+                unwatchDirectory(QFileInfo(filePath).absolutePath());
+            } else {
+                d->fileSystemWatcher.removePath(filePath);
+            }
+        }
+    }
+}
+
+void ImageFileWatcher::watchFile(const QString &filePath)
+{
+    if (QFile::exists(filePath)) {
+        // files which have been replaced are not watched anymore by the
+        // underlying file system notification, so watch them again
+        d->fileSystemWatcher.removePath(filePath);
+        d->fileSystemWatcher.addPath(filePath);
+        if (d->missingFilePaths.remove(filePath)) {
+            unwatchDirectory(QFileInfo(filePath).absolutePath());
+        }
+    } else {
+        d->missingFilePaths.insert(filePath);
+        QString directoryPath = QFileInfo(filePath).absolutePath();
+        if (!d->fileSystemWatcher.directories().contains(directoryPath)) {
+            d->fileSystemWatcher.addPath(directoryPath);
+        }
+    }
+}
+
+void ImageFileWatcher::unwatchDirectory(const QString &directoryPath)
+{
+    bool stillMissing = false;
+    foreach (const QString &missingFilePath, d->missingFilePaths) {
+        if (QFileInfo(missingFilePath).absolutePath() == directoryPath) {
+            stillMissing = true;
+            break;
+        }
+    }
+    if (!stillMissing) {
+        d->fileSystemWatcher.removePath(directoryPath);
+    }
+}
+
+// private slots
+
+void ImageFileWatcher::handleModelAdded(ScreenieModelInterface &screenieModel)
+{
+    watch(screenieModel);
+}
+
+void ImageFileWatcher::handleModelRemoved(ScreenieModelInterface &screenieModel)
+{
+    unwatch(screenieModel);
+}
+
+void ImageFileWatcher::handleModelsAdded(const QList<ScreenieModelInterface *> &screenieModels)
+{
+    foreach (ScreenieModelInterface *screenieModel, screenieModels) {
+        handleModelAdded(*screenieModel);
+    }
+}
+
+void ImageFileWatcher::handleModelsRemoved(const QList<ScreenieModelInterface *> &screenieModels)
+{
+    foreach (ScreenieModelInterface *screenieModel, screenieModels) {
+        handleModelRemoved(*screenieModel);
+    }
+}
+
+void ImageFileWatcher::handleFilePathChanged()
+{
+    ScreenieModelInterface *screenieModel = qobject_cast<ScreenieModelInterface *>(sender());
+    if (screenieModel != 0) {
+        unwatch(*screenieModel);
+        watch(*screenieModel);
+    }
+}
+
+void ImageFileWatcher::handleFileChanged(const QString &filePath)
+{
+    d->changedFilePaths.insert(filePath);
+    // restart the timer: the files are only reloaded once the burst of modifications is over
+    d->debounceTimer.start();
+}
+
+void ImageFileWatcher::handleDirectoryChanged(const QString &directoryPath)
+{
+    foreach (const QString &missingFilePath, d->missingFilePaths) {
+        if (QFileInfo(missingFilePath).absolutePath() == directoryPath && QFile::exists(missingFilePath)) {
+            d->changedFilePaths.insert(missingFilePath);
+            d->debounceTimer.start();
+        }
+    }
+}
+
+void ImageFileWatcher::reloadChangedFiles()
+{
+    foreach (const QString &filePath, d->changedFilePaths) {
+        if (d->watchedModels.contains(filePath)) {
+            watchFile(filePath);
+            if (!d->missingFilePaths.contains(filePath)) {
+                // the image is read once in a background thread, for all models which refer to it
+                ScreenieFilePathModel::reload(d->watchedModels.value(filePath));
+            }
+        }
+    }
+    d->changedFilePaths.clear();
+}
@@ -0,0 +1,71 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef IMAGEFILEWATCHER_H
+#define IMAGEFILEWATCHER_H
+
+#include <QtCore/QObject>
+#include <QtCore/QList>
+
+class QString;
+
+class ScreenieScene;
+class ScreenieModelInterface;
+class ImageFileWatcherPrivate;
+
+/*!
+ * Watches the image files referenced by the ScreenieFilePathModel instances of a
+ * ScreenieScene and reloads the affected models when their files are modified.
+ *
+ * Bursts of modifications - as caused by applications which write files in several
+ * steps - are collected and handled once the file has not been modified for a short
+ * while. Files which are replaced (deleted and re-created) are watched via their
+ * parent directory until they re-appear.
+ *
+ * \sa ScreenieFilePathModel#reload()
+ */
+class ImageFileWatcher : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ImageFileWatcher(const ScreenieScene &screenieScene);
+    virtual ~ImageFileWatcher();
+
+private:
+    ImageFileWatcherPrivate *d;
+
+    void frenchConnection();
+    void watch(ScreenieModelInterface &screenieModel);
+    void unwatch(ScreenieModelInterface &screenieModel);
+    void watchFile(const QString &filePath);
+    void unwatchDirectory(const QString &directoryPath);
+
+private slots:
+    void handleModelAdded(ScreenieModelInterface &screenieModel);
+    void handleModelRemoved(ScreenieModelInterface &screenieModel);
+    void handleModelsAdded(const QList<ScreenieModelInterface *> &screenieModels);
+    void handleModelsRemoved(const QList<ScreenieModelInterface *> &screenieModels);
+    void handleFilePathChanged();
+    void handleFileChanged(const QString &filePath);
+    void handleDirectoryChanged(const QString &directoryPath);
+    void reloadChangedFiles();
+};
+
+#endif // IMAGEFILEWATCHER_H
@@ -0,0 +1,94 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QtCore/QObject>
+#include <QtCore/QList>
+#include <QtCore/QTimer>
+
+#include "ScreeniePixmapItem.h"
+#include "ItemUpdateScheduler.h"
+
+class ItemUpdateSchedulerPrivate
+{
+public:
+    QList<ScreeniePixmapItem *> scheduledItems;
+    QTimer timer;
+};
+
+// public
+
+ItemUpdateScheduler::ItemUpdateScheduler(QObject *parent)
+    : QObject(parent),
+      d(new ItemUpdateSchedulerPrivate())
+{
+    // fires as soon as all pending events have been processed, that is
+    // typically before the views repaint the scene
+    d->timer.setSingleShot(true);
+    d->timer.setInterval(0);
+    frenchConnection();
+}
+
+ItemUpdateScheduler::~ItemUpdateScheduler()
+{
+    delete d;
+}
+
+void ItemUpdateScheduler::schedule(ScreeniePixmapItem &screeniePixmapItem)
+{
+    d->scheduledItems.append(&screeniePixmapItem);
+    if (!d->timer.isActive()) {
+        d->timer.start();
+    }
+}
+
+void ItemUpdateScheduler::cancel(ScreeniePixmapItem &screeniePixmapItem)
+{
+    d->scheduledItems.removeOne(&screeniePixmapItem);
+}
+
+void ItemUpdateScheduler::flush()
+{
+    d->timer.stop();
+    processUpdates();
+}
+
+// private
+
+void ItemUpdateScheduler::frenchConnection()
+{
+    connect(&d->timer, SIGNAL(timeout()),
+            this, SLOT(processUpdates()));
+}
+
+// private slots
+
+void ItemUpdateScheduler::processUpdates()
+{
+    // items which become dirty again while being processed are
+    // scheduled for the next round
+    QList<ScreeniePixmapItem *> scheduledItems = d->scheduledItems;
+    d->scheduledItems.clear();
+#ifdef DEBUG
+    qDebug("ItemUpdateScheduler::processUpdates: processing %d items", scheduledItems.count());
+#endif
+    foreach (ScreeniePixmapItem *screeniePixmapItem, scheduledItems) {
+        screeniePixmapItem->processPendingUpdates();
+    }
+}
@@ -0,0 +1,76 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef ITEMUPDATESCHEDULER_H
+#define ITEMUPDATESCHEDULER_H
+
+#include <QtCore/QObject>
+
+class ScreeniePixmapItem;
+class ItemUpdateSchedulerPrivate;
+
+/*!
+ * Collects the ScreeniePixmapItem instances with pending (\em dirty) updates and processes
+ * them together once control returns to the event loop, that is before the next frame is
+ * painted. An item which changes several times in between is therefore updated only once.
+ *
+ * \sa ScreeniePixmapItem#processPendingUpdates()
+ */
+class ItemUpdateScheduler : public QObject
+{
+    Q_OBJECT
+public:
+    explicit ItemUpdateScheduler(QObject *parent = 0);
+    virtual ~ItemUpdateScheduler();
+
+    /*!
+     * Schedules the pending updates of the \p screeniePixmapItem. The caller
+     * is responsible to schedule each item only once until its updates have
+     * been processed.
+     *
+     * \param screeniePixmapItem
+     *        the ScreeniePixmapItem which has pending updates
+     */
+    void schedule(ScreeniePixmapItem &screeniePixmapItem);
+
+    /*!
+     * Removes the \p screeniePixmapItem from the scheduled items, typically because
+     * it is about to be deleted.
+     */
+    void cancel(ScreeniePixmapItem &screeniePixmapItem);
+
+    /*!
+     * Processes the scheduled updates right away, typically because the scene is
+     * about to be rendered before control returns to the event loop, for instance
+     * when it is exported.
+     */
+    void flush();
+
+private:
+    Q_DISABLE_COPY(ItemUpdateScheduler)
+    ItemUpdateSchedulerPrivate *d;
+
+    void frenchConnection();
+
+private slots:
+    void processUpdates();
+};
+
+#endif // ITEMUPDATESCHEDULER_H
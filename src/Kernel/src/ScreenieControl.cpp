@@ -20,20 +20,23 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QList>
+#include <QtCore/QHash>
+#include <QtCore/QSet>
 #include <QtCore/QPoint>
 #include <QtCore/QPointF>
 #include <QtCore/QRectF>
 #include <QtCore/QStringList>
-#include <QtCore/QtAlgorithms>
 #include <QtCore/QMimeData>
 #include <QtCore/QUrl>
 #include <QtCore/QDir>
+#include <QtCore/qmath.h>
 #include <QtGui/QColor>
 #include <QtGui/QGraphicsView>
 #include <QtGui/QGraphicsItem>
 #include <QtGui/QBrush>
 #include <QtGui/QImage>
 #include <QtGui/QPainter>
+#include <QtGui/QTransform>
 #include <QtGui/QMainWindow>
 #include <QtGui/QSlider>
 
@@ -46,29 +49,26 @@
 #include "../../Model/src/ScreenieImageModel.h"
 #include "../../Model/src/ScreenieTemplateModel.h"
 #include "TemplateOrganizer.h"
+#include "ImageFileWatcher.h"
 #include "Reflection.h"
+#include "ItemUpdateScheduler.h"
 #include "ScreenieGraphicsScene.h"
 #include "ScreeniePixmapItem.h"
 
 #include "ScreenieControl.h"
 
-namespace
-{
-    bool zSort(const ScreeniePixmapItem *item1, const ScreeniePixmapItem *item2)
-    {
-        // closer items come first in the sorted list
-        return item1->getScreenieModel().getDistance() > item2->getScreenieModel().getDistance();
-    }
-}; // anonymous
-
 class ScreenieControlPrivate
 {
 public:
     ScreenieControlPrivate(ScreenieScene &theScreenieScene, ScreenieGraphicsScene &theScreenieGraphicsScene)
         : screenieScene(theScreenieScene),
           screenieGraphicsScene(theScreenieGraphicsScene),
+          renderQuality(ScreenieControl::MaximumQuality),
+          editRenderQuality(ScreenieControl::MaximumQuality),
+          editing(false),
           reflection(new Reflection()),
-          templateOrganizer(theScreenieScene)
+          templateOrganizer(theScreenieScene),
+          imageFileWatcher(theScreenieScene)
     {}
 
     ~ScreenieControlPrivate()
@@ -80,11 +80,54 @@ public:
     ScreenieGraphicsScene &screenieGraphicsScene;
     QBrush checkerBoardBrush;
     QTimer qualityTimer;
+    ScreenieControl::RenderQuality renderQuality;
+    // the render quality during edit operations, as adapted to the measured frame time:
+    // the next edit operation starts with this quality again
+    ScreenieControl::RenderQuality editRenderQuality;
+    bool editing;
+    ItemUpdateScheduler updateScheduler;
     Reflection *reflection; /*!\todo The Reflection effect does not belong here. Add an "FX Manager" which keeps track of effects instead */
     DefaultScreenieModel defaultScreenieModel;
     TemplateOrganizer templateOrganizer;
+    ImageFileWatcher imageFileWatcher;
+    // the item of each model, and the selected models: kept up to date with
+    // the scene, so lookups don't need to enumerate all QGraphicsScene items
+    QHash<ScreenieModelInterface *, ScreeniePixmapItem *> screeniePixmapItems;
+    QSet<ScreenieModelInterface *> selectedModels;
+    QTimer releaseTimer;
+    // the area exposed by the views since the last realization: the items are
+    // realized once the views have finished painting
+    QRectF exposedRect;
+    QTimer realizeTimer;
+    // the models whose items have been far off the visible area at the last release check
+    QSet<ScreenieModelInterface *> distantModels;
+
+    static const int TargetFrameTime;
+    static const int IdleDelay;
+    static const int RefinementDelay;
+    static const int ReleaseInterval;
+    static const qreal ZoomStep;
+    static const qreal MinZoom;
+    static const qreal MaxZoom;
 };
 
+// the frame time in milliseconds (25 fps) which the render quality is adapted
+// to during edit operations
+const int ScreenieControlPrivate::TargetFrameTime = 40;
+// the delay in milliseconds after the last edit operation, before the render
+// quality is refined again
+const int ScreenieControlPrivate::IdleDelay = 300;
+// the delay in milliseconds between the refinement steps
+const int ScreenieControlPrivate::RefinementDelay = 100;
+// the interval in milliseconds in which the pixmaps of items far off the visible
+// area are released
+const int ScreenieControlPrivate::ReleaseInterval = 10000;
+// the zoom factor of one zoom step
+const qreal ScreenieControlPrivate::ZoomStep = 1.25;
+// the minimum and maximum zoom factors of the views
+const qreal ScreenieControlPrivate::MinZoom = 0.1;
+const qreal ScreenieControlPrivate::MaxZoom = 8.0;
+
 // public
 
 ScreenieControl::ScreenieControl(ScreenieScene &screenieScene, ScreenieGraphicsScene &screenieGraphicsScene)
@@ -92,8 +135,10 @@ ScreenieControl::ScreenieControl(ScreenieScene &screenieScene, ScreenieGraphicsS
       d(new ScreenieControlPrivate(screenieScene, screenieGraphicsScene))
 {
     d->qualityTimer.setSingleShot(true);
-    d->qualityTimer.setInterval(300);
+    d->realizeTimer.setSingleShot(true);
+    d->realizeTimer.setInterval(0);
     frenchConnection();
+    d->releaseTimer.start(ScreenieControlPrivate::ReleaseInterval);
 }
 
 ScreenieControl::~ScreenieControl()
@@ -104,10 +149,10 @@ ScreenieControl::~ScreenieControl()
 QList<ScreenieModelInterface *> ScreenieControl::getSelectedScreenieModels() const
 {
     QList<ScreenieModelInterface *> result;
-    foreach (QGraphicsItem *selectedItem, d->screenieGraphicsScene.selectedItems()) {
-        if (selectedItem->type() == ScreeniePixmapItem::ScreeniePixmapType) {
-            ScreeniePixmapItem *screeniePixmapItem = static_cast<ScreeniePixmapItem *>(selectedItem);
-            result.append(&screeniePixmapItem->getScreenieModel());
+    // in scene order: copying, duplicating and stacking depend on the order
+    foreach (ScreenieModelInterface *screenieModel, d->screenieScene.getModels()) {
+        if (d->selectedModels.contains(screenieModel)) {
+            result.append(screenieModel);
         }
     }
     return result;
@@ -116,14 +161,10 @@ QList<ScreenieModelInterface *> ScreenieControl::getSelectedScreenieModels() con
 QList<ScreenieTemplateModel *> ScreenieControl::getSelectedTemplateModels() const
 {
     QList<ScreenieTemplateModel *> result;
-    foreach (QGraphicsItem *selectedItem, d->screenieGraphicsScene.selectedItems()) {
-        if (selectedItem->type() == ScreeniePixmapItem::ScreeniePixmapType) {
-            ScreeniePixmapItem *screeniePixmapItem = static_cast<ScreeniePixmapItem *>(selectedItem);
-            ScreenieModelInterface &screenieModel = screeniePixmapItem->getScreenieModel();
-            ScreenieTemplateModel *screenieTemplateModel = qobject_cast<ScreenieTemplateModel *>(&screenieModel);
-            if (screenieTemplateModel != 0) {
-                result.append(screenieTemplateModel);
-            }
+    foreach (ScreenieModelInterface *screenieModel, getSelectedScreenieModels()) {
+        ScreenieTemplateModel *screenieTemplateModel = qobject_cast<ScreenieTemplateModel *>(screenieModel);
+        if (screenieTemplateModel != 0) {
+            result.append(screenieTemplateModel);
         }
     }
     return result;
@@ -132,14 +173,10 @@ QList<ScreenieTemplateModel *> ScreenieControl::getSelectedTemplateModels() cons
 QList<ScreenieFilePathModel *> ScreenieControl::getSelectedFilePathModels() const
 {
     QList<ScreenieFilePathModel *> result;
-    foreach (QGraphicsItem *selectedItem, d->screenieGraphicsScene.selectedItems()) {
-        if (selectedItem->type() == ScreeniePixmapItem::ScreeniePixmapType) {
-            ScreeniePixmapItem *screeniePixmapItem = static_cast<ScreeniePixmapItem *>(selectedItem);
-            ScreenieModelInterface &screenieModel = screeniePixmapItem->getScreenieModel();
-            ScreenieFilePathModel *screenieFilePathModel = qobject_cast<ScreenieFilePathModel *>(&screenieModel);
-            if (screenieFilePathModel != 0) {
-                result.append(screenieFilePathModel);
-            }
+    foreach (ScreenieModelInterface *screenieModel, getSelectedScreenieModels()) {
+        ScreenieFilePathModel *screenieFilePathModel = qobject_cast<ScreenieFilePathModel *>(screenieModel);
+        if (screenieFilePathModel != 0) {
+            result.append(screenieFilePathModel);
         }
     }
     return result;
@@ -153,10 +190,21 @@ DefaultScreenieModel &ScreenieControl::getDefaultScreenieModel()
 void ScreenieControl::updateScene()
 {
    d->screenieGraphicsScene.clear();
+   d->screeniePixmapItems.clear();
+   d->selectedModels.clear();
+   d->distantModels.clear();
    handleBackgroundChanged();
+   // items only request their images once they are about to be painted
    foreach (ScreenieModelInterface *screenieModel, d->screenieScene.getModels()) {
        handleModelAdded(*screenieModel);
    }
+   // as before, the last model in the scene ends up selected
+   if (d->screenieScene.count() > 0) {
+       ScreenieModelInterface *lastModel = d->screenieScene.getModels().last();
+       foreach (ScreeniePixmapItem *screeniePixmapItem, getScreeniePixmapItems()) {
+           screeniePixmapItem->setSelected(&screeniePixmapItem->getScreenieModel() == lastModel);
+       }
+   }
 }
 
 void ScreenieControl::updateModel(const QMimeData *mimeData, ScreenieModelInterface &screenieModel)
@@ -192,14 +240,16 @@ void ScreenieControl::addImage(QString filePath, QPointF centerPosition)
 void ScreenieControl::addImages(QStringList filePaths, QPointF centerPosition)
 {
     QPointF position = centerPosition;
+    QList<ScreenieModelInterface *> screenieModels;
     foreach (QString filePath, filePaths) {
         ScreenieModelInterface *screenieModel = new ScreenieFilePathModel(filePath);
         applyDefaultValues(*screenieModel);
         QPointF itemPosition = calculateItemPosition(*screenieModel, position);
         position += QPointF(20.0, 20.0);
         screenieModel->setPosition(itemPosition);
-        d->screenieScene.addModel(screenieModel);
+        screenieModels.append(screenieModel);
     }
+    d->screenieScene.addModels(screenieModels);
 }
 
 void ScreenieControl::addImage(QImage image, QPointF centerPosition)
@@ -212,14 +262,16 @@ void ScreenieControl::addImage(QImage image, QPointF centerPosition)
 void ScreenieControl::addImages(QList<QImage> images, QPointF centerPosition)
 {
     QPointF position = centerPosition;
+    QList<ScreenieModelInterface *> screenieModels;
     foreach (QImage image, images) {
         ScreenieImageModel *screenieModel = new ScreenieImageModel(image);
         applyDefaultValues(*screenieModel);
         QPointF itemPosition = calculateItemPosition(*screenieModel, position);
         position += QPointF(20.0, 20.0);
         screenieModel->setPosition(itemPosition);
-        d->screenieScene.addModel(screenieModel);
+        screenieModels.append(screenieModel);
     }
+    d->screenieScene.addModels(screenieModels);
 }
 
 void ScreenieControl::addTemplate(QPointF centerPosition)
@@ -233,16 +285,13 @@ void ScreenieControl::addTemplate(QPointF centerPosition)
 
 void ScreenieControl::removeAll()
 {
-    QList<ScreenieModelInterface *> screenieModels = getSelectedScreenieModels();
-    foreach (ScreenieModelInterface *screenieModel, screenieModels) {
-        d->screenieScene.removeModel(screenieModel);
-    }
+    d->screenieScene.removeModels(getSelectedScreenieModels());
 }
 
 void ScreenieControl::selectAll()
 {
-    foreach(QGraphicsItem *item, d->screenieGraphicsScene.items()) {
-        item->setSelected(true);
+    foreach (ScreeniePixmapItem *screeniePixmapItem, d->screeniePixmapItems) {
+        screeniePixmapItem->setSelected(true);
     }
 }
 
@@ -250,27 +299,33 @@ void ScreenieControl::setPositionX(qreal x, ScreenieModelInterface *screenieMode
 {
     updateEditRenderQuality();
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->setPositionX(x);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setPositionY(qreal y, ScreenieModelInterface *screenieModel)
 {
     updateEditRenderQuality();
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->setPositionY(y);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setPosition(QPointF position, ScreenieModelInterface *screenieModel)
 {
     updateEditRenderQuality();
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->setPosition(position);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::translate(qreal dx, qreal dy, ScreenieModelInterface *screenieModel)
@@ -280,89 +335,109 @@ void ScreenieControl::translate(qreal dx, qreal dy, ScreenieModelInterface *scre
         updateEditRenderQuality();
     }
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->translate(dx, dy);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setRotation(int angle, ScreenieModelInterface *screenieModel)
 {
     updateEditRenderQuality();
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->setRotation(angle);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::rotate(int angle, ScreenieModelInterface *screenieModel)
 {
     updateEditRenderQuality();
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->rotate(angle);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setDistance(qreal distance, ScreenieModelInterface *screenieModel)
 {
     updateEditRenderQuality();
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->setDistance(distance);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::addDistance(qreal distance, ScreenieModelInterface *screenieModel)
 {
     updateEditRenderQuality();
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->addDistance(distance);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setReflectionEnabled(bool enable, ScreenieModelInterface *screenieModel)
 {
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->setReflectionEnabled(enable);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setReflectionOffset(int reflectionOffset, ScreenieModelInterface *screenieModel)
 {
     updateEditRenderQuality();
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->setReflectionOffset(reflectionOffset);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::addReflectionOffset(int reflectionOffset, ScreenieModelInterface *screenieModel)
 {
     updateEditRenderQuality();
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->addReflectionOffset(reflectionOffset);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setReflectionOpacity(int reflectionOpacity, ScreenieModelInterface *screenieModel)
 {
     updateEditRenderQuality();
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->setReflectionOpacity(reflectionOpacity);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::addReflectionOpacity(int reflectionOpacity, ScreenieModelInterface *screenieModel)
 {
     updateEditRenderQuality();
     QList<ScreenieModelInterface *> screenieModels = getEditableModels(screenieModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         screenieModel->addReflectionOpacity(reflectionOpacity);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setBackgroundEnabled(bool enable)
@@ -400,41 +475,51 @@ void ScreenieControl::setFilePath(const QString &filePath, ScreenieFilePathModel
 {
     QList<ScreenieFilePathModel *> screenieFilePathModels = getEditableFilePathModels(screenieFilePathModel);
     QString qtFilePath = QDir::fromNativeSeparators(filePath);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieFilePathModel *screenieFilePathModel, screenieFilePathModels) {
         screenieFilePathModel->setFilePath(qtFilePath);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setTargetWidth(int width, ScreenieTemplateModel *screenieTemplateModel)
 {
     QList<ScreenieTemplateModel *> screenieTemplateModels = getEditableTemplateModels(screenieTemplateModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieTemplateModel *screenieTemplateModel, screenieTemplateModels) {
         screenieTemplateModel->getSizeFitter().setTargetWidth(width);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setTargetHeight(int height, ScreenieTemplateModel *screenieTemplateModel)
 {
     QList<ScreenieTemplateModel *> screenieTemplateModels = getEditableTemplateModels(screenieTemplateModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieTemplateModel *screenieTemplateModel, screenieTemplateModels) {
         screenieTemplateModel->getSizeFitter().setTargetHeight(height);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setFitMode(SizeFitter::FitMode fitMode, ScreenieTemplateModel *screenieTemplateModel)
 {
     QList<ScreenieTemplateModel *> screenieTemplateModels = getEditableTemplateModels(screenieTemplateModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieTemplateModel *screenieTemplateModel, screenieTemplateModels) {
         screenieTemplateModel->getSizeFitter().setFitMode(fitMode);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::setFitOptionEnabled(SizeFitter::FitOption fitOption, bool enable, ScreenieTemplateModel *screenieTemplateModel)
 {
     QList<ScreenieTemplateModel *> screenieTemplateModels = getEditableTemplateModels(screenieTemplateModel);
+    d->screenieScene.beginUpdate();
     foreach (ScreenieTemplateModel *screenieTemplateModel, screenieTemplateModels) {
         screenieTemplateModel->getSizeFitter().setFitOptionEnabled(fitOption, enable);
     }
+    d->screenieScene.endUpdate();
 }
 
 void ScreenieControl::convertItemsToTemplate(ScreenieScene &screenieScene)
@@ -449,48 +534,102 @@ void ScreenieControl::convertItemsToTemplate(ScreenieScene &screenieScene)
             nonTemplateItems.append(screenieModel);
         }
     }
-    foreach (ScreenieModelInterface *screenieModel, nonTemplateItems) {
-        screenieScene.removeModel(screenieModel);
-    }
-    foreach (ScreenieModelInterface *screenieModel, templateItems) {
-        screenieScene.addModel(screenieModel);
-    }
+    screenieScene.beginUpdate();
+    screenieScene.removeModels(nonTemplateItems);
+    screenieScene.addModels(templateItems);
+    screenieScene.endUpdate();
 }
 
 void ScreenieControl::setRenderQuality(RenderQuality renderQuality)
 {
-    QList<ScreeniePixmapItem *> items = getScreeniePixmapItems();
+    Qt::TransformationMode transformationMode;
+    QPainter::RenderHints renderHints;
     switch (renderQuality) {
     case LowQuality:
-        foreach (ScreeniePixmapItem *item, items) {
-            item->setTransformationMode(Qt::FastTransformation);
-        }
-        foreach (QGraphicsView *view, d->screenieGraphicsScene.views()) {
-            view->setRenderHints(QPainter::NonCosmeticDefaultPen);
-        }
+        transformationMode = Qt::FastTransformation;
+        renderHints = QPainter::NonCosmeticDefaultPen;
+        break;
+    case MediumQuality:
+        transformationMode = Qt::SmoothTransformation;
+        renderHints = QPainter::SmoothPixmapTransform;
+        break;
+    case HighQuality:
+        transformationMode = Qt::SmoothTransformation;
+        renderHints = QPainter::Antialiasing|QPainter::SmoothPixmapTransform;
         break;
     case MaximumQuality:
-        foreach (ScreeniePixmapItem *item, items) {
-            item->setTransformationMode(Qt::SmoothTransformation);
-        }
-        foreach (QGraphicsView *view, d->screenieGraphicsScene.views()) {
-            view->setRenderHints(QPainter::Antialiasing|QPainter::SmoothPixmapTransform|QPainter::TextAntialiasing);
-        }
     default:
+        transformationMode = Qt::SmoothTransformation;
+        renderHints = QPainter::Antialiasing|QPainter::SmoothPixmapTransform|QPainter::TextAntialiasing;
         break;
     }
+    foreach (ScreeniePixmapItem *item, getScreeniePixmapItems()) {
+        item->setTransformationMode(transformationMode);
+    }
+    bool renderHintsChanged = false;
+    foreach (QGraphicsView *view, d->screenieGraphicsScene.views()) {
+        renderHintsChanged = renderHintsChanged || view->renderHints() != renderHints;
+        view->setRenderHints(renderHints);
+    }
+    if (renderHintsChanged) {
+        // Qt does not invalidate the item caches when only the render hints change:
+        // cached items - including those cached during an interaction - would keep
+        // being painted at the previous quality
+        // only the pixmap items are ever cached
+        foreach (ScreeniePixmapItem *screeniePixmapItem, d->screeniePixmapItems) {
+            if (screeniePixmapItem->cacheMode() != QGraphicsItem::NoCache) {
+                screeniePixmapItem->update();
+            }
+        }
+    }
+    d->renderQuality = renderQuality;
+}
+
+void ScreenieControl::zoom(qreal steps)
+{
+    qreal factor = qPow(ScreenieControlPrivate::ZoomStep, steps);
+    foreach (QGraphicsView *view, d->screenieGraphicsScene.views()) {
+        // the views are only ever scaled uniformly
+        qreal currentZoom = view->transform().m11();
+        qreal newZoom = qBound(ScreenieControlPrivate::MinZoom, currentZoom * factor, ScreenieControlPrivate::MaxZoom);
+        if (!qFuzzyCompare(newZoom, currentZoom)) {
+            view->setTransformationAnchor(QGraphicsView::AnchorUnderMouse);
+            view->setTransform(QTransform::fromScale(newZoom, newZoom));
+        }
+    }
+    // the items which come into view are realized before the views repaint
+    realizeItems(getVisibleSceneRect());
+}
+
+void ScreenieControl::zoomIn()
+{
+    zoom(1.0);
+}
+
+void ScreenieControl::zoomOut()
+{
+    zoom(-1.0);
+}
+
+void ScreenieControl::resetZoom()
+{
+    foreach (QGraphicsView *view, d->screenieGraphicsScene.views()) {
+        view->resetTransform();
+    }
 }
 
 // private
 
 void ScreenieControl::frenchConnection()
 {
-    connect(&d->screenieScene, SIGNAL(distanceChanged()),
-            this, SLOT(handleDistanceChanged()));
     connect(&d->screenieScene, SIGNAL(modelAdded(ScreenieModelInterface &)),
             this, SLOT(handleModelAdded(ScreenieModelInterface &)));
     connect(&d->screenieScene, SIGNAL(modelRemoved(ScreenieModelInterface &)),
             this, SLOT(handleModelRemoved(ScreenieModelInterface &)));
+    connect(&d->screenieScene, SIGNAL(modelsAdded(const QList<ScreenieModelInterface *> &)),
+            this, SLOT(handleModelsAdded(const QList<ScreenieModelInterface *> &)));
+    connect(&d->screenieScene, SIGNAL(modelsRemoved(const QList<ScreenieModelInterface *> &)),
+            this, SLOT(handleModelsRemoved(const QList<ScreenieModelInterface *> &)));
     connect(&d->screenieScene, SIGNAL(backgroundChanged()),
             this, SLOT(handleBackgroundChanged()));
     connect(&d->screenieGraphicsScene, SIGNAL(imagesDropped(QList<QImage>, QPointF)),
@@ -503,40 +642,62 @@ void ScreenieControl::frenchConnection()
             this, SLOT(addDistance(qreal)));
     connect(&d->screenieGraphicsScene, SIGNAL(translate(qreal, qreal)),
             this, SLOT(translate(qreal, qreal)));
+    connect(&d->screenieGraphicsScene, SIGNAL(zoom(qreal)),
+            this, SLOT(zoom(qreal)));
     connect(&d->qualityTimer, SIGNAL(timeout()),
             this, SLOT(restoreRenderQuality()));
+    connect(&d->screenieGraphicsScene, SIGNAL(frameRendered(int)),
+            this, SLOT(handleFrameRendered(int)));
+    connect(&d->screenieGraphicsScene, SIGNAL(aboutToRender(const QRectF &)),
+            this, SLOT(handleAboutToRender(const QRectF &)));
+    connect(&d->screenieGraphicsScene, SIGNAL(renderRequested(const QRectF &)),
+            this, SLOT(handleRenderRequested(const QRectF &)));
+    connect(&d->realizeTimer, SIGNAL(timeout()),
+            this, SLOT(realizeExposedItems()));
+    connect(&d->releaseTimer, SIGNAL(timeout()),
+            this, SLOT(releaseDistantItems()));
 }
 
 QList<ScreeniePixmapItem *> ScreenieControl::getScreeniePixmapItems() const
 {
-    QList<ScreeniePixmapItem *> result;
-    foreach (QGraphicsItem *item, d->screenieGraphicsScene.items()) {
-        if (item->type() == ScreeniePixmapItem::ScreeniePixmapType) {
-            ScreeniePixmapItem *screeniePixmapItem = static_cast<ScreeniePixmapItem *>(item);
-            result.append(screeniePixmapItem);
-        }
+    return d->screeniePixmapItems.values();
+}
+
+QRectF ScreenieControl::getVisibleSceneRect() const
+{
+    QRectF result;
+    foreach (QGraphicsView *view, d->screenieGraphicsScene.views()) {
+        result |= view->mapToScene(view->viewport()->rect()).boundingRect();
     }
     return result;
 }
 
+void ScreenieControl::realizeItems(const QRectF &rect)
+{
+    if (!rect.isEmpty()) {
+        // also realize the items just outside the area, so they are ready when
+        // scrolled into view
+        QRectF realizeRect = rect.adjusted(-rect.width() / 2.0, -rect.height() / 2.0, rect.width() / 2.0, rect.height() / 2.0);
+        foreach (QGraphicsItem *item, d->screenieGraphicsScene.items(realizeRect, Qt::IntersectsItemBoundingRect)) {
+            if (item->type() == ScreeniePixmapItem::ScreeniePixmapType) {
+                static_cast<ScreeniePixmapItem *>(item)->realize();
+            }
+        }
+    }
+}
+
 void ScreenieControl::updateEditRenderQuality()
 {
-    switch (Settings::getInstance().getEditRenderQuality())
-    {
-    case Settings::LowQuality: // fall-thru intended (for now)
-    case Settings::MediumQuality:
-        setRenderQuality(LowQuality);
-        d->qualityTimer.start();
-        break;
-    case Settings::HighQuality: // fall-thru intended (for now)
-    case Settings::MaximumQuality:
-       break;
-    default:
-#ifdef DEBUG
-       qCritical("ScreenieControl::updateRenderQuality: UNSUPPORTED render quality: %d", Settings::getInstance().getEditRenderQuality());
-#endif
-       break;
+    if (!d->editing) {
+        d->editing = true;
+        // the items which are not being edited remain unchanged: cache them
+        d->screenieGraphicsScene.beginInteraction();
+        RenderQuality minimumQuality = static_cast<RenderQuality>(Settings::getInstance().getEditRenderQuality());
+        if (minimumQuality != MaximumQuality) {
+            setRenderQuality(qMax(d->editRenderQuality, minimumQuality));
+        }
     }
+    d->qualityTimer.start(ScreenieControlPrivate::IdleDelay);
 }
 
 void ScreenieControl::applyDefaultValues(ScreenieModelInterface &screenieModelInterface)
@@ -729,42 +890,72 @@ void ScreenieControl::handleImageDrop(QList<QImage> images, QPointF centerPositi
     }
 }
 
-void ScreenieControl::handleDistanceChanged()
-{
-    QList<ScreeniePixmapItem *> screeniePixmapItems;
-    foreach (QGraphicsItem *graphicsItem, d->screenieGraphicsScene.items()) {
-        if (graphicsItem->type() == ScreeniePixmapItem::ScreeniePixmapType) {
-            ScreeniePixmapItem *screeniePixmapItem = static_cast<ScreeniePixmapItem *>(graphicsItem);
-            screeniePixmapItems.append(screeniePixmapItem);
-        }
-    }
-    ::qSort(screeniePixmapItems.begin(), screeniePixmapItems.end(), zSort);
-    int z = 0;
-    foreach (QGraphicsItem *graphicsItem, screeniePixmapItems) {
-        graphicsItem->setZValue(z++);
-    }
-}
-
 void ScreenieControl::handleModelAdded(ScreenieModelInterface &screenieModel)
 {
-    ScreeniePixmapItem *screeniePixmapItem = new ScreeniePixmapItem(screenieModel, *this, *d->reflection);
+    ScreeniePixmapItem *screeniePixmapItem = new ScreeniePixmapItem(screenieModel, *this, *d->reflection, d->updateScheduler);
     screeniePixmapItem->setPos(screenieModel.getPosition());
+    d->screeniePixmapItems.insert(&screenieModel, screeniePixmapItem);
+    // the scene re-uses the models when being updated: connect only once
+    connect(&screenieModel, SIGNAL(selectionChanged()),
+            this, SLOT(handleModelSelectionChanged()), Qt::UniqueConnection);
     d->screenieGraphicsScene.clearSelection();
     screeniePixmapItem->setSelected(true);
     d->screenieGraphicsScene.addItem(screeniePixmapItem);
-    handleDistanceChanged();
+    // a re-used model may still be flagged as selected, in which case no
+    // selectionChanged() signal has been emitted
+    d->selectedModels.insert(&screenieModel);
 }
 
 void ScreenieControl::handleModelRemoved(ScreenieModelInterface &screenieModel)
 {
-    foreach (QGraphicsItem *graphicsItem, d->screenieGraphicsScene.items()) {
-        if (graphicsItem->type() == ScreeniePixmapItem::ScreeniePixmapType) {
-            ScreeniePixmapItem *screeniePixmapItem = static_cast<ScreeniePixmapItem *>(graphicsItem);
-            if (&screenieModel == &screeniePixmapItem->getScreenieModel()) {
-                d->screenieGraphicsScene.removeItem(screeniePixmapItem);
-                delete screeniePixmapItem;
-                break;
-            }
+    d->selectedModels.remove(&screenieModel);
+    d->distantModels.remove(&screenieModel);
+    ScreeniePixmapItem *screeniePixmapItem = d->screeniePixmapItems.take(&screenieModel);
+    if (screeniePixmapItem != 0) {
+        d->screenieGraphicsScene.removeItem(screeniePixmapItem);
+        delete screeniePixmapItem;
+    }
+}
+
+void ScreenieControl::handleModelsAdded(const QList<ScreenieModelInterface *> &screenieModels)
+{
+    d->screenieGraphicsScene.clearSelection();
+    foreach (ScreenieModelInterface *screenieModel, screenieModels) {
+        // copies (e.g. when pasting) keep the selection state of their originals:
+        // the models must agree with their (unselected) items
+        if (screenieModel != screenieModels.last()) {
+            screenieModel->setSelected(false);
+        }
+        ScreeniePixmapItem *screeniePixmapItem = new ScreeniePixmapItem(*screenieModel, *this, *d->reflection, d->updateScheduler);
+        screeniePixmapItem->setPos(screenieModel->getPosition());
+        d->screeniePixmapItems.insert(screenieModel, screeniePixmapItem);
+        connect(screenieModel, SIGNAL(selectionChanged()),
+                this, SLOT(handleModelSelectionChanged()), Qt::UniqueConnection);
+        d->screenieGraphicsScene.addItem(screeniePixmapItem);
+    }
+    // as with single models the last added model ends up selected
+    if (screenieModels.count() > 0) {
+        ScreenieModelInterface *lastModel = screenieModels.last();
+        d->screeniePixmapItems.value(lastModel)->setSelected(true);
+        d->selectedModels.insert(lastModel);
+    }
+}
+
+void ScreenieControl::handleModelsRemoved(const QList<ScreenieModelInterface *> &screenieModels)
+{
+    foreach (ScreenieModelInterface *screenieModel, screenieModels) {
+        handleModelRemoved(*screenieModel);
+    }
+}
+
+void ScreenieControl::handleModelSelectionChanged()
+{
+    ScreenieModelInterface *screenieModel = qobject_cast<ScreenieModelInterface *>(sender());
+    if (screenieModel != 0) {
+        if (screenieModel->isSelected()) {
+            d->selectedModels.insert(screenieModel);
+        } else {
+            d->selectedModels.remove(screenieModel);
         }
     }
 }
@@ -786,6 +977,80 @@ void ScreenieControl::handleBackgroundChanged()
 
 void ScreenieControl::restoreRenderQuality()
 {
-    setRenderQuality(MaximumQuality);
+    if (d->editing) {
+        d->editing = false;
+        d->screenieGraphicsScene.endInteraction();
+    }
+    // refine progressively, one quality step at a time
+    if (d->renderQuality < MaximumQuality) {
+        setRenderQuality(static_cast<RenderQuality>(d->renderQuality + 1));
+        if (d->renderQuality < MaximumQuality) {
+            d->qualityTimer.start(ScreenieControlPrivate::RefinementDelay);
+        }
+    }
+}
+
+void ScreenieControl::handleFrameRendered(int milliseconds)
+{
+    if (d->editing) {
+        RenderQuality minimumQuality = static_cast<RenderQuality>(Settings::getInstance().getEditRenderQuality());
+        // hysteresis: only step up again when there is ample headroom
+        if (milliseconds > ScreenieControlPrivate::TargetFrameTime && d->renderQuality > minimumQuality) {
+            d->editRenderQuality = static_cast<RenderQuality>(d->renderQuality - 1);
+            setRenderQuality(d->editRenderQuality);
+        } else if (milliseconds < ScreenieControlPrivate::TargetFrameTime / 3 && d->renderQuality < MaximumQuality) {
+            d->editRenderQuality = static_cast<RenderQuality>(d->renderQuality + 1);
+            setRenderQuality(d->editRenderQuality);
+        }
+#ifdef DEBUG
+        qDebug("ScreenieControl::handleFrameRendered: %d ms, render quality: %d", milliseconds, d->renderQuality);
+#endif
+    }
+}
+
+void ScreenieControl::handleAboutToRender(const QRectF &rect)
+{
+    // the items are being painted: realizing them now would change their geometry
+    // in the middle of the paint event
+    d->exposedRect |= rect;
+    if (!d->realizeTimer.isActive()) {
+        d->realizeTimer.start();
+    }
 }
 
+void ScreenieControl::handleRenderRequested(const QRectF &rect)
+{
+    // the scene is rendered before control returns to the event loop (export):
+    // the items are painted with their latest pixmaps rather than their placeholders
+    realizeItems(rect);
+    d->updateScheduler.flush();
+}
+
+void ScreenieControl::realizeExposedItems()
+{
+    realizeItems(d->exposedRect);
+    d->exposedRect = QRectF();
+}
+
+void ScreenieControl::releaseDistantItems()
+{
+    if (d->screenieGraphicsScene.views().count() > 0) {
+        QRectF visibleRect = getVisibleSceneRect();
+        QRectF keepRect = visibleRect.adjusted(-visibleRect.width(), -visibleRect.height(), visibleRect.width(), visibleRect.height());
+        QSet<ScreenieModelInterface *> distantModels;
+        foreach (ScreeniePixmapItem *screeniePixmapItem, getScreeniePixmapItems()) {
+            if (screeniePixmapItem->isRealized() && !screeniePixmapItem->isSelected()
+                && !keepRect.intersects(screeniePixmapItem->sceneBoundingRect())) {
+                ScreenieModelInterface *screenieModel = &screeniePixmapItem->getScreenieModel();
+                // only release items which have been far off for two consecutive checks,
+                // so panning back and forth does not re-create the pixmaps
+                if (d->distantModels.contains(screenieModel)) {
+                    screeniePixmapItem->release();
+                } else {
+                    distantModels.insert(screenieModel);
+                }
+            }
+        }
+        d->distantModels = distantModels;
+    }
+}
@@ -24,6 +24,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QTimer>
 #include <QtCore/QPointF>
+#include <QtCore/QRectF>
 #include <QtCore/QString>
 #include <QtCore/QStringList>
 #include <QtCore/QList>
@@ -57,12 +58,15 @@ class ScreenieControl : public QObject
     Q_OBJECT
 public:
     /*!
-     * Defines the QGraphicsView render quality.
+     * Defines the QGraphicsView render quality. The values correspond to
+     * the Settings#EditRenderQuality values.
      */
     enum RenderQuality
     {
-        LowQuality, /*!< Antialiasing disabled, fast pixmap transformation */
-        MaximumQuality /*!< Antialiasing enabled, smooth pixmap transformation */
+        LowQuality = 0, /*!< Antialiasing disabled, fast pixmap transformation */
+        MediumQuality = 1, /*!< Antialiasing disabled, smooth pixmap transformation */
+        HighQuality = 2, /*!< Antialiasing enabled for pixmaps but not for text, smooth pixmap transformation */
+        MaximumQuality = 3 /*!< Antialiasing enabled, smooth pixmap transformation */
     };
 
     KERNEL_API ScreenieControl(ScreenieScene &screenieScene, ScreenieGraphicsScene &screenieGraphicsScene);
@@ -124,12 +128,28 @@ public slots:
     KERNEL_API void convertItemsToTemplate(ScreenieScene &screenieScene);
     KERNEL_API void setRenderQuality(RenderQuality renderQuality);
 
+    /*!
+     * Zooms all views of the scene by the given number of \p steps, around the mouse
+     * position if the mouse is over the view. Positive values zoom in, negative values
+     * zoom out. The zoom is limited to the range from 10% to 800%.
+     */
+    KERNEL_API void zoom(qreal steps);
+    KERNEL_API void zoomIn();
+    KERNEL_API void zoomOut();
+    KERNEL_API void resetZoom();
+
 private:
     ScreenieControlPrivate *d;
 
     void frenchConnection();
 
     QList<ScreeniePixmapItem *> getScreeniePixmapItems() const;
+    // returns the scene area which is visible in any of the views
+    QRectF getVisibleSceneRect() const;
+    // realizes the items within 'rect', and within a margin around it
+    void realizeItems(const QRectF &rect);
+    // called before each edit operation: the render quality is then adapted to the
+    // measured frame time until the edit operations are over
     void updateEditRenderQuality();
     void applyDefaultValues(ScreenieModelInterface &screenieModelInterface);
     /*!\todo Put these methods in some Kernel "Geometry" class or somewhere */
@@ -152,11 +172,18 @@ private:
 private slots:
     void handleFilePathsDrop(QStringList filePaths, QPointF centerPosition);
     void handleImageDrop(QList<QImage> images, QPointF centerPosition);
-    void handleDistanceChanged();
     void handleModelAdded(ScreenieModelInterface &screenieModel);
     void handleModelRemoved(ScreenieModelInterface &screenieModel);
+    void handleModelsAdded(const QList<ScreenieModelInterface *> &screenieModels);
+    void handleModelsRemoved(const QList<ScreenieModelInterface *> &screenieModels);
+    void handleModelSelectionChanged();
     void handleBackgroundChanged();
     void restoreRenderQuality();
+    void handleFrameRendered(int milliseconds);
+    void handleAboutToRender(const QRectF &rect);
+    void handleRenderRequested(const QRectF &rect);
+    void realizeExposedItems();
+    void releaseDistantItems();
 };
 
 #endif // SCREENIECONTROL_H
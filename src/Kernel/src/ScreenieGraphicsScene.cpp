@@ -25,28 +25,44 @@
 #include <QtCore/QList>
 #include <QtCore/QPointF>
 #include <QtCore/QTimer>
+#include <QtCore/QTime>
+#include <QtCore/QRectF>
+#include <QtCore/QVariant>
 #include <QtGui/QImage>
 #include <QtGui/QGraphicsSceneDragDropEvent>
+#include <QtGui/QGraphicsSceneMouseEvent>
+#include <QtGui/QGraphicsSceneWheelEvent>
+#include <QtGui/QGraphicsItem>
 #include <QtGui/QDropEvent>
 #include <QtGui/QWidget>
 #include <QtGui/QGraphicsScene>
 #include <QtGui/QPinchGesture>
 #include <QtGui/QGraphicsView>
+#include <QtGui/QPainter>
 
 #include "../../Utils/src/Settings.h"
 #include "Clipboard/MimeHelper.h"
+#include "ScreeniePixmapItem.h"
 #include "ScreenieGraphicsScene.h"
 
 class ScreenieGraphicsScenePrivate
 {
 public:
     ScreenieGraphicsScenePrivate()
-        : itemDragDrop(false)
+        : itemDragDrop(false),
+          interactionCount(0),
+          mouseInteraction(false)
     {}
 
     bool itemDragDrop;
+    int interactionCount;
+    bool mouseInteraction;
+    // started when a view starts painting the background
+    QTime frameTime;
 };
 
+const int ScreenieGraphicsScene::CacheModeKey = 0;
+
 // public
 
 ScreenieGraphicsScene::ScreenieGraphicsScene(QObject *parent)
@@ -63,6 +79,29 @@ ScreenieGraphicsScene::~ScreenieGraphicsScene()
 #endif
 }
 
+void ScreenieGraphicsScene::beginInteraction()
+{
+    ++d->interactionCount;
+    if (d->interactionCount == 1) {
+        setStaticItemsCached(true);
+    }
+}
+
+void ScreenieGraphicsScene::endInteraction()
+{
+    if (d->interactionCount > 0) {
+        --d->interactionCount;
+        if (d->interactionCount == 0) {
+            setStaticItemsCached(false);
+        }
+    }
+}
+
+void ScreenieGraphicsScene::prepareRender(const QRectF &rect)
+{
+    emit renderRequested(rect);
+}
+
 // protected
 
 void ScreenieGraphicsScene::dragEnterEvent(QGraphicsSceneDragDropEvent *event)
@@ -126,6 +165,51 @@ bool ScreenieGraphicsScene::event(QEvent *event)
     return result;
 }
 
+void ScreenieGraphicsScene::mousePressEvent(QGraphicsSceneMouseEvent *event)
+{
+    QGraphicsScene::mousePressEvent(event);
+    // the pressed item has been selected by now
+    if (!d->mouseInteraction && mouseGrabberItem() != 0) {
+        d->mouseInteraction = true;
+        beginInteraction();
+    }
+}
+
+void ScreenieGraphicsScene::mouseReleaseEvent(QGraphicsSceneMouseEvent *event)
+{
+    QGraphicsScene::mouseReleaseEvent(event);
+    if (d->mouseInteraction && event->buttons() == Qt::NoButton) {
+        d->mouseInteraction = false;
+        endInteraction();
+    }
+}
+
+void ScreenieGraphicsScene::wheelEvent(QGraphicsSceneWheelEvent *event)
+{
+    QGraphicsScene::wheelEvent(event);
+    // items handle the wheel themselves (also with CTRL pressed, which some
+    // platforms send for pinch gestures): only zoom over the background
+    if (!event->isAccepted() && (Qt::ControlModifier & event->modifiers())) {
+        // one step per wheel notch (120 = 15 degrees)
+        emit zoom(event->delta() / 120.0);
+        event->accept();
+    }
+}
+
+void ScreenieGraphicsScene::drawBackground(QPainter *painter, const QRectF &rect)
+{
+    // the background is painted first, the foreground last
+    d->frameTime.start();
+    emit aboutToRender(rect);
+    QGraphicsScene::drawBackground(painter, rect);
+}
+
+void ScreenieGraphicsScene::drawForeground(QPainter *painter, const QRectF &rect)
+{
+    QGraphicsScene::drawForeground(painter, rect);
+    emit frameRendered(d->frameTime.elapsed());
+}
+
 // private
 
 bool ScreenieGraphicsScene::gestureEvent(const QGestureEvent *event)
@@ -165,4 +249,31 @@ bool ScreenieGraphicsScene::pinchTriggered(const QPinchGesture *gesture)
     return result;
 }
 
-
+void ScreenieGraphicsScene::setStaticItemsCached(bool enable)
+{
+    // items which change nevertheless - e.g. because they get selected during the
+    // interaction - are simply re-cached by Qt
+    if (enable) {
+        // each cache takes the device size of its item: only the visible items,
+        // which are repainted during the interaction, are worth caching
+        QRectF visibleRect;
+        foreach (QGraphicsView *view, views()) {
+            visibleRect |= view->mapToScene(view->viewport()->rect()).boundingRect();
+        }
+        foreach (QGraphicsItem *item, items(visibleRect, Qt::IntersectsItemBoundingRect)) {
+            if (item->type() == ScreeniePixmapItem::ScreeniePixmapType && !item->isSelected() &&
+                item->cacheMode() == QGraphicsItem::NoCache && static_cast<ScreeniePixmapItem *>(item)->isRealized()) {
+                item->setData(CacheModeKey, item->cacheMode());
+                item->setCacheMode(QGraphicsItem::DeviceCoordinateCache);
+            }
+        }
+    } else {
+        foreach (QGraphicsItem *item, items()) {
+            QVariant cacheMode = item->data(CacheModeKey);
+            if (cacheMode.isValid()) {
+                item->setCacheMode(static_cast<QGraphicsItem::CacheMode>(cacheMode.toInt()));
+                item->setData(CacheModeKey, QVariant());
+            }
+        }
+    }
+}
@@ -26,6 +26,8 @@
 #include <QtGui/QGraphicsScene>
 
 class QGraphicsSceneDragDropEvent;
+class QGraphicsSceneMouseEvent;
+class QGraphicsSceneWheelEvent;
 class QEvent;
 class QCursor;
 class QKeyEvent;
@@ -34,6 +36,8 @@ class QGestureEvent;
 class QPinchGesture;
 class QGesture;
 class QObject;
+class QPainter;
+class QRectF;
 
 #include "KernelLib.h"
 
@@ -46,9 +50,50 @@ class ScreenieGraphicsScene : public QGraphicsScene
 {
     Q_OBJECT
 public:
+    /*!
+     * The QGraphicsItem#data() key under which the cache mode of an item is stored while an
+     * interaction is in progress. Items which change their cache mode during an interaction
+     * must store the new cache mode under this key instead, as it is restored when the
+     * interaction ends.
+     *
+     * \sa #beginInteraction()
+     */
+    KERNEL_API static const int CacheModeKey;
+
     KERNEL_API explicit ScreenieGraphicsScene(QObject *parent = 0);
     KERNEL_API virtual ~ScreenieGraphicsScene();
 
+    /*!
+     * Starts an interaction with the selected items, such as moving or rotating them.
+     * The items which are \em not selected remain unchanged during the interaction:
+     * the visible ones are cached in device coordinates, so repainting the scene essentially
+     * only composites the selected items over the cached ones. The selected items
+     * on the other hand are not cached, as they change with every repaint.
+     *
+     * Interactions may be nested; the cached items are released when the outermost
+     * interaction ends. Mouse interactions with items are handled by this scene itself.
+     *
+     * \sa #endInteraction()
+     */
+    KERNEL_API void beginInteraction();
+
+    /*!
+     * Ends the interaction started with #beginInteraction().
+     */
+    KERNEL_API void endInteraction();
+
+    /*!
+     * Brings the items within the \p rect up to date, before (part of) this scene is
+     * rendered with QGraphicsScene#render(), e.g. for export. Must be called before
+     * rendering, as QGraphicsScene#render() collects the items before it paints the
+     * background.
+     *
+     * \param rect
+     *        the area to be rendered in scene coordinates
+     * \sa #renderRequested(const QRectF &)
+     */
+    KERNEL_API void prepareRender(const QRectF &rect);
+
 signals:
     void imagesDropped(QList<QImage> images, QPointF position);
     void filePathsDropped(QStringList filePaths, QPointF position);
@@ -56,17 +101,58 @@ signals:
     void addDistance(qreal distance);
     void translate(qreal x, qreal y);
 
+    /*!
+     * Emitted when the wheel is turned with CTRL pressed over the background.
+     *
+     * \param steps
+     *        the number of zoom steps; positive values zoom in, negative values zoom out
+     */
+    void zoom(qreal steps);
+
+    /*!
+     * Emitted whenever a view has painted (part of) this scene.
+     *
+     * \param milliseconds
+     *        the time it took to paint the background, the items and the foreground
+     */
+    void frameRendered(int milliseconds);
+
+    /*!
+     * Emitted before (part of) this scene is painted, either by a view or when
+     * the scene is rendered, e.g. for export. The items are about to be painted:
+     * receivers must not change them right away.
+     *
+     * \param rect
+     *        the exposed area in scene coordinates
+     */
+    void aboutToRender(const QRectF &rect);
+
+    /*!
+     * Emitted by #prepareRender(const QRectF &): receivers bring the items within
+     * the \p rect up to date.
+     *
+     * \param rect
+     *        the area to be rendered in scene coordinates
+     */
+    void renderRequested(const QRectF &rect);
+
 protected:
     virtual void dragEnterEvent(QGraphicsSceneDragDropEvent *event);
     virtual void dragMoveEvent(QGraphicsSceneDragDropEvent *event);
     virtual void dropEvent(QGraphicsSceneDragDropEvent *event);
     virtual bool event(QEvent *event);
+    virtual void mousePressEvent(QGraphicsSceneMouseEvent *event);
+    virtual void mouseReleaseEvent(QGraphicsSceneMouseEvent *event);
+    virtual void wheelEvent(QGraphicsSceneWheelEvent *event);
+    virtual void drawBackground(QPainter *painter, const QRectF &rect);
+    virtual void drawForeground(QPainter *painter, const QRectF &rect);
 
 private:
     ScreenieGraphicsScenePrivate *d;
 
     bool gestureEvent(const QGestureEvent *event);
     bool pinchTriggered(const QPinchGesture *gesture);
+    void setStaticItemsCached(bool enable);
 };
 
 #endif // SCREENIEGRAPHICSSCENE_H
@@ -24,6 +24,8 @@
 #include <QtCore/QMimeData>
 #include <QtCore/QUrl>
 #include <QtCore/QEvent>
+#include <QtCore/QPointer>
+#include <QtCore/QVariant>
 #include <QtGui/QGraphicsPixmapItem>
 #include <QtGui/QGraphicsItem>
 #include <QtGui/QGraphicsScene>
@@ -43,6 +45,8 @@
 #include "../../Model/src/SceneLimits.h"
 #include "Clipboard/MimeHelper.h"
 #include "Reflection.h"
+#include "ItemUpdateScheduler.h"
+#include "ScreenieGraphicsScene.h"
 #include "ScreenieControl.h"
 #include "PropertyDialogFactory.h"
 #include "ScreeniePixmapItem.h"
@@ -52,10 +56,13 @@ const int ScreeniePixmapItem::ScreeniePixmapType = QGraphicsItem::UserType + 1;
 class ScreeniePixmapItemPrivate
 {
 public:
-    ScreeniePixmapItemPrivate(ScreenieModelInterface &theScreenieModel, ScreenieControl &theScreenieControl, Reflection &theReflection)
+    ScreeniePixmapItemPrivate(ScreenieModelInterface &theScreenieModel, ScreenieControl &theScreenieControl, Reflection &theReflection, ItemUpdateScheduler &theUpdateScheduler)
         : screenieModel(theScreenieModel),
           screenieControl(theScreenieControl),
           reflection(theReflection),
+          updateScheduler(&theUpdateScheduler),
+          dirtyFlags(NotDirty),
+          realized(false),
           transformPixmap(true),
           ignoreUpdates(false),
           itemTransformed(false),
@@ -68,9 +75,29 @@ public:
         delete propertyDialogFactory;
     }
 
+    /*!
+     * The parts of the item which need to be updated, accumulated until
+     * the ItemUpdateScheduler processes them.
+     */
+    enum DirtyFlag {
+        NotDirty = 0x0,
+        PixmapDirty = 0x1,
+        ReflectionDirty = 0x2,
+        GeometryDirty = 0x4,
+        OverlayDirty = 0x8
+    };
+
     ScreenieModelInterface &screenieModel;
     ScreenieControl &screenieControl;
     Reflection &reflection;
+    // the ScreenieControl - and hence the scheduler - may be deleted before its items
+    QPointer<ItemUpdateScheduler> updateScheduler;
+    int dirtyFlags;
+    // the most recent image from the model; requested from the model when null
+    QImage pendingImage;
+    bool realized;
+    // the size of the item while not realized
+    QSizeF proxySize;
     bool transformPixmap;
     bool ignoreUpdates;
     bool itemTransformed;
@@ -88,9 +115,9 @@ const int ScreeniePixmapItemPrivate::ContextActionThreshold = 2;
 
 // public
 
-ScreeniePixmapItem::ScreeniePixmapItem(ScreenieModelInterface &screenieModel, ScreenieControl &screenieControl, Reflection &reflection)
+ScreeniePixmapItem::ScreeniePixmapItem(ScreenieModelInterface &screenieModel, ScreenieControl &screenieControl, Reflection &reflection, ItemUpdateScheduler &updateScheduler)
     : QGraphicsPixmapItem(),
-      d(new ScreeniePixmapItemPrivate(screenieModel, screenieControl, reflection))
+      d(new ScreeniePixmapItemPrivate(screenieModel, screenieControl, reflection, updateScheduler))
 {
     setFlag(QGraphicsItem::ItemIsMovable, true);
     setFlag(QGraphicsItem::ItemIsSelectable, true);
@@ -99,7 +126,10 @@ ScreeniePixmapItem::ScreeniePixmapItem(ScreenieModelInterface &screenieModel, Sc
     // we also want to be able to change the reflection also in the fully translucent areas
     // of the reflection
     setShapeMode(QGraphicsPixmapItem::BoundingRectShape);
-    updatePixmap(d->screenieModel.readImage());
+    // the pixmap is only created once the item is about to become visible
+    updateProxySize();
+    applyItemGeometry();
+    updateStackingOrder();
     setAcceptDrops(true);
     frenchConnection();
 }
@@ -109,6 +139,9 @@ ScreeniePixmapItem::~ScreeniePixmapItem()
 #ifdef DEBUG
     qDebug("ScreeniePixmapItem::~ScreeniePixmapItem: called.");
 #endif
+    if (d->dirtyFlags != ScreeniePixmapItemPrivate::NotDirty && !d->updateScheduler.isNull()) {
+        d->updateScheduler->cancel(*this);
+    }
 }
 
 ScreenieModelInterface &ScreeniePixmapItem::getScreenieModel() const
@@ -116,6 +149,87 @@ ScreenieModelInterface &ScreeniePixmapItem::getScreenieModel() const
     return d->screenieModel;
 }
 
+void ScreeniePixmapItem::processPendingUpdates()
+{
+    int dirtyFlags = d->dirtyFlags;
+    d->dirtyFlags = ScreeniePixmapItemPrivate::NotDirty;
+    if (!d->realized) {
+        // the image is requested again when realized
+        d->pendingImage = QImage();
+        if (dirtyFlags & (ScreeniePixmapItemPrivate::PixmapDirty | ScreeniePixmapItemPrivate::ReflectionDirty)) {
+            // the image size or the reflection may have changed the item size
+            updateProxySize();
+            applyItemGeometry();
+        } else if (dirtyFlags & ScreeniePixmapItemPrivate::GeometryDirty) {
+            applyItemGeometry();
+        }
+    } else if (dirtyFlags & ScreeniePixmapItemPrivate::PixmapDirty) {
+        QImage image = d->pendingImage.isNull() ? d->screenieModel.requestImage() : d->pendingImage;
+        d->pendingImage = QImage();
+        // also applies the reflection and the geometry
+        applyPixmap(image);
+    } else {
+        if (dirtyFlags & ScreeniePixmapItemPrivate::ReflectionDirty) {
+            applyReflection();
+        }
+        if (dirtyFlags & ScreeniePixmapItemPrivate::GeometryDirty) {
+            applyItemGeometry();
+        }
+    }
+    if (dirtyFlags & ScreeniePixmapItemPrivate::OverlayDirty) {
+        update();
+    }
+}
+
+bool ScreeniePixmapItem::isRealized() const
+{
+    return d->realized;
+}
+
+void ScreeniePixmapItem::realize()
+{
+    if (!d->realized) {
+        // the proxy bounding box must still be reported while the geometry change is prepared
+        prepareGeometryChange();
+        d->realized = true;
+        QImage image = d->pendingImage.isNull() ? d->screenieModel.requestImage() : d->pendingImage;
+        d->pendingImage = QImage();
+        applyPixmap(image);
+    }
+}
+
+void ScreeniePixmapItem::release()
+{
+    if (d->realized) {
+        d->proxySize = pixmap().size();
+        prepareGeometryChange();
+        d->realized = false;
+        setPixmap(QPixmap());
+    }
+}
+
+QRectF ScreeniePixmapItem::boundingRect() const
+{
+    QRectF result;
+    if (d->realized) {
+        result = QGraphicsPixmapItem::boundingRect();
+    } else {
+        result = QRectF(offset(), d->proxySize);
+    }
+    return result;
+}
+
+QPainterPath ScreeniePixmapItem::shape() const
+{
+    QPainterPath result;
+    if (d->realized) {
+        result = QGraphicsPixmapItem::shape();
+    } else {
+        result.addRect(boundingRect());
+    }
+    return result;
+}
+
 // protected
 
 int ScreeniePixmapItem::type() const
@@ -275,6 +389,8 @@ void ScreeniePixmapItem::frenchConnection()
             this, SLOT(updateItemGeometry()));
     connect(&d->screenieModel, SIGNAL(distanceChanged()),
             this, SLOT(updateItemGeometry()));
+    connect(&d->screenieModel, SIGNAL(distanceChanged()),
+            this, SLOT(updateStackingOrder()));
     connect(&d->screenieModel, SIGNAL(reflectionChanged()),
             this, SLOT(updateReflection()));
     connect(&d->screenieModel, SIGNAL(imageChanged(const QImage &)),
@@ -422,10 +538,24 @@ QPoint ScreeniePixmapItem::calculateDialogPosition(const QPoint &mousePosition)
     return result;
 }
 
+void ScreeniePixmapItem::markDirty(int dirtyFlags)
+{
+    if (d->dirtyFlags == ScreeniePixmapItemPrivate::NotDirty && !d->updateScheduler.isNull()) {
+        d->updateScheduler->schedule(*this);
+    }
+    d->dirtyFlags |= dirtyFlags;
+}
 
-// private slots
+void ScreeniePixmapItem::applyPixmap(const QImage &image)
+{
+    QPixmap pixmap;
+    pixmap.convertFromImage(image);
+    setPixmap(pixmap);
+    applyReflection();
+    applyItemGeometry();
+}
 
-void ScreeniePixmapItem::updateReflection()
+void ScreeniePixmapItem::applyReflection()
 {
     QPixmap pixmap = this->pixmap();
     if (d->screenieModel.isReflectionEnabled()) {
@@ -443,21 +573,7 @@ void ScreeniePixmapItem::updateReflection()
     setPixmap(pixmap);
 }
 
-void ScreeniePixmapItem::updatePixmap(const QImage &image)
-{
-    QPixmap pixmap;
-    pixmap.convertFromImage(image);
-    setPixmap(pixmap);
-    updateReflection();
-    updateItemGeometry();
-}
-
-void ScreeniePixmapItem::updatePixmap()
-{
-    updatePixmap(d->screenieModel.readImage());
-}
-
-void ScreeniePixmapItem::updateItemGeometry()
+void ScreeniePixmapItem::applyItemGeometry()
 {
     QTransform transform;
     QTransform scale;
@@ -466,24 +582,91 @@ void ScreeniePixmapItem::updateItemGeometry()
     qreal centerScale = 1.0 - 0.9 * d->screenieModel.getDistance() / SceneLimits::MaxDistance;
     scale = QTransform().scale(centerScale, centerScale);
 
-    QPixmap pixmap = this->pixmap();
-    qreal dx = pixmap.width() / 2.0;
+    QSizeF size = getItemSize();
+    qreal dx = size.width() / 2.0;
     qreal dy;
     if (d->screenieModel.isReflectionEnabled()) {
-        dy =  pixmap.height() / 4.0;
+        dy =  size.height() / 4.0;
     } else {
-        dy = pixmap.height() / 2.0;
+        dy = size.height() / 2.0;
     }
     transform.translate(dx, dy);
     transform.rotate(d->screenieModel.getRotation(), Qt::YAxis);
     translateBack.translate(-dx, -dy);
     transform = translateBack * scale * transform;
     setTransform(transform, false);
+    // rotated items are warped with a projective transform, the most expensive
+    // way to paint a pixmap: cache the warped result in device coordinates, which
+    // Qt re-uses until the transform, the pixmap or the view transform change
+    QGraphicsItem::CacheMode cacheMode = transform.isAffine() ? QGraphicsItem::NoCache : QGraphicsItem::DeviceCoordinateCache;
+    if (data(ScreenieGraphicsScene::CacheModeKey).isValid()) {
+        // an interaction is in progress: the cache mode is restored afterwards
+        setData(ScreenieGraphicsScene::CacheModeKey, cacheMode);
+    } else {
+        setCacheMode(cacheMode);
+    }
+}
+
+QSizeF ScreeniePixmapItem::getItemSize() const
+{
+    QSizeF result;
+    if (d->realized) {
+        result = pixmap().size();
+    } else {
+        result = d->proxySize;
+    }
+    return result;
+}
+
+void ScreeniePixmapItem::updateProxySize()
+{
+    QSizeF size = d->screenieModel.getSize();
+    if (d->screenieModel.isReflectionEnabled()) {
+        // the reflection doubles the height
+        size.setHeight(size.height() * 2.0);
+    }
+    if (size != d->proxySize) {
+        prepareGeometryChange();
+        d->proxySize = size;
+    }
+}
+
+// private slots
+
+void ScreeniePixmapItem::updateReflection()
+{
+    markDirty(ScreeniePixmapItemPrivate::ReflectionDirty);
+}
+
+void ScreeniePixmapItem::updatePixmap(const QImage &image)
+{
+    d->pendingImage = image;
+    markDirty(ScreeniePixmapItemPrivate::PixmapDirty);
+}
+
+void ScreeniePixmapItem::updatePixmap()
+{
+    // the image is requested when the pending updates are processed
+    d->pendingImage = QImage();
+    markDirty(ScreeniePixmapItemPrivate::PixmapDirty);
+}
+
+void ScreeniePixmapItem::updateItemGeometry()
+{
+    markDirty(ScreeniePixmapItemPrivate::GeometryDirty);
+}
+
+void ScreeniePixmapItem::updateStackingOrder()
+{
+    // closer items are stacked on top; the QGraphicsScene keeps its items
+    // ordered by z-value itself, so only this item needs to be updated.
+    // Items with equal distance are stacked in insertion order
+    setZValue(-d->screenieModel.getDistance());
 }
 
 void ScreeniePixmapItem::updateItem()
 {
-    update();
+    markDirty(ScreeniePixmapItemPrivate::OverlayDirty);
 }
 
 void ScreeniePixmapItem::updatePosition()
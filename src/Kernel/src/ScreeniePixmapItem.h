@@ -24,6 +24,9 @@
 #include <QtCore/QPoint>
 #include <QtCore/QPointF>
 #include <QtCore/QVariant>
+#include <QtCore/QRectF>
+#include <QtCore/QSizeF>
+#include <QtGui/QPainterPath>
 #include <QtGui/QGraphicsPixmapItem>
 
 class QSize;
@@ -37,6 +40,7 @@ class QImage;
 class ScreenieModelInterface;
 class ScreenieControl;
 class Reflection;
+class ItemUpdateScheduler;
 class ScreeniePixmapItemPrivate;
 
 /*!
@@ -53,11 +57,44 @@ public:
      */
     KERNEL_API static const int ScreeniePixmapType;
 
-    KERNEL_API ScreeniePixmapItem(ScreenieModelInterface &screenieModel, ScreenieControl &screenieControl, Reflection &reflection);
+    KERNEL_API ScreeniePixmapItem(ScreenieModelInterface &screenieModel, ScreenieControl &screenieControl, Reflection &reflection, ItemUpdateScheduler &updateScheduler);
     KERNEL_API virtual ~ScreeniePixmapItem();
 
     KERNEL_API ScreenieModelInterface &getScreenieModel() const;
 
+    /*!
+     * Applies the accumulated changes of the model - pixmap, reflection, geometry and
+     * overlay - to this item. Called by the ItemUpdateScheduler once per frame.
+     *
+     * \sa ItemUpdateScheduler
+     */
+    KERNEL_API void processPendingUpdates();
+
+    /*!
+     * Returns whether the pixmap (and reflection) of this item have been created.
+     * Items which are not realized are lightweight proxies: they have the bounding box
+     * of the realized item, but no pixmap.
+     *
+     * \sa #realize()
+     * \sa #release()
+     */
+    KERNEL_API bool isRealized() const;
+
+    /*!
+     * Creates the pixmap and the reflection of this item, typically because it is
+     * about to become visible.
+     */
+    KERNEL_API void realize();
+
+    /*!
+     * Releases the pixmap and the reflection of this item, typically because it has
+     * not been visible for a while. The item keeps its bounding box.
+     */
+    KERNEL_API void release();
+
+    virtual QRectF boundingRect() const;
+    virtual QPainterPath shape() const;
+
 protected:
     virtual int type() const;
     virtual void mousePressEvent(QGraphicsSceneMouseEvent *event);
@@ -82,12 +119,19 @@ private:
     void addReflectionOpacity(int reflectionOpacity);
     void selectExclusive();
     QPoint calculateDialogPosition(const QPoint &mousePosition);
+    void markDirty(int dirtyFlags);
+    void applyPixmap(const QImage &image);
+    void applyReflection();
+    void applyItemGeometry();
+    QSizeF getItemSize() const;
+    void updateProxySize();
 
 private slots:
     void updateReflection();
     void updatePixmap(const QImage &image);
     void updatePixmap();
     void updateItemGeometry();
+    void updateStackingOrder();
     void updateItem();
     void updatePosition();
     void updateSelection();
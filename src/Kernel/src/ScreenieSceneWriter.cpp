@@ -0,0 +1,164 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QtCore/QObject>
+#include <QtCore/QString>
+#include <QtCore/QFile>
+#include <QtCore/QFuture>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QtConcurrentRun>
+#include <QtGui/QImage>
+
+#include "../../Utils/src/FileUtils.h"
+#include "../../Utils/src/Settings.h"
+#include "../../Model/src/ScreenieScene.h"
+#include "../../Model/src/Dao/ScreenieSceneDao.h"
+#include "../../Model/src/Dao/ScreenieSceneDaoFactory.h"
+#include "ScreenieSceneWriter.h"
+
+class ScreenieSceneWriterPrivate
+{
+public:
+    ScreenieSceneWriterPrivate()
+        : screenieScene(0),
+          snapshot(0),
+          sceneChanged(false)
+    {}
+
+    // the written scene; reset to 0 when the scene is destroyed while writing
+    ScreenieScene *screenieScene;
+    ScreenieScene *snapshot;
+    QString filePath;
+    bool sceneChanged;
+    QFutureWatcher<bool> writeWatcher;
+
+    /*
+     * Writes the 'snapshot' to a temporary file which then replaces the 'filePath'.
+     * Called in a worker thread.
+     */
+    static bool writeSnapshot(const ScreenieScene *snapshot, const QString &filePath, bool compressed, const QImage &preview)
+    {
+        bool result;
+        QString temporaryFilePath = filePath + ".saving";
+        QFile file(temporaryFilePath);
+        // the format is determined by the actual file path
+        ScreenieSceneDao *screenieSceneDao = ScreenieSceneDaoFactory::createWriter(file, filePath, compressed);
+        screenieSceneDao->setPreview(preview);
+        result = screenieSceneDao->write(*snapshot);
+        delete screenieSceneDao;
+        if (result) {
+            result = FileUtils::replaceFile(temporaryFilePath, filePath);
+        }
+        if (!result) {
+            QFile::remove(temporaryFilePath);
+        }
+#ifdef DEBUG
+        qDebug("ScreenieSceneWriterPrivate::writeSnapshot: %s, result: %d", qPrintable(filePath), result);
+#endif
+        return result;
+    }
+};
+
+// public
+
+ScreenieSceneWriter::ScreenieSceneWriter(QObject *parent)
+    : QObject(parent),
+      d(new ScreenieSceneWriterPrivate())
+{
+    frenchConnection();
+}
+
+ScreenieSceneWriter::~ScreenieSceneWriter()
+{
+    // the file is completed, even if nobody is interested in the result anymore
+    d->writeWatcher.waitForFinished();
+    delete d->snapshot;
+    delete d;
+}
+
+void ScreenieSceneWriter::write(ScreenieScene &screenieScene, const QString &filePath, const QImage &preview)
+{
+    waitForFinished();
+    d->screenieScene = &screenieScene;
+    d->snapshot = screenieScene.copy();
+    d->filePath = filePath;
+    d->sceneChanged = false;
+    connect(d->screenieScene, SIGNAL(changed()),
+            this, SLOT(handleSceneChanged()));
+    connect(d->screenieScene, SIGNAL(destroyed()),
+            this, SLOT(handleSceneDestroyed()));
+    // read here, in the main thread: the models of the snapshot only read the
+    // maximum image size in the worker thread, which Settings guards
+    bool compressed = Settings::getInstance().isCompressSceneFilesEnabled();
+    d->writeWatcher.setFuture(QtConcurrent::run(&ScreenieSceneWriterPrivate::writeSnapshot, d->snapshot, filePath, compressed, preview));
+}
+
+bool ScreenieSceneWriter::isWriting() const
+{
+    return d->snapshot != 0;
+}
+
+void ScreenieSceneWriter::waitForFinished()
+{
+    if (isWriting()) {
+        d->writeWatcher.waitForFinished();
+        handleWriteFinished();
+    }
+}
+
+// private
+
+void ScreenieSceneWriter::frenchConnection()
+{
+    connect(&d->writeWatcher, SIGNAL(finished()),
+            this, SLOT(handleWriteFinished()));
+}
+
+// private slots
+
+void ScreenieSceneWriter::handleWriteFinished()
+{
+    // the write might already have been completed by waitForFinished()
+    if (isWriting()) {
+        bool ok = d->writeWatcher.result();
+        ScreenieScene *screenieScene = d->screenieScene;
+        // the snapshot is deleted in the thread it has been created in
+        delete d->snapshot;
+        d->snapshot = 0;
+        if (d->screenieScene != 0) {
+            disconnect(d->screenieScene, 0, this, 0);
+            if (ok && !d->sceneChanged) {
+                d->screenieScene->setModified(false);
+            }
+            d->screenieScene = 0;
+        }
+        emit finished(ok, d->filePath, screenieScene);
+    }
+}
+
+void ScreenieSceneWriter::handleSceneChanged()
+{
+    d->sceneChanged = true;
+}
+
+void ScreenieSceneWriter::handleSceneDestroyed()
+{
+    d->screenieScene = 0;
+}
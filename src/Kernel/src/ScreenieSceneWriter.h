@@ -0,0 +1,96 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef SCREENIESCENEWRITER_H
+#define SCREENIESCENEWRITER_H
+
+#include <QtCore/QObject>
+
+class QString;
+class QImage;
+
+class ScreenieScene;
+class ScreenieSceneWriterPrivate;
+
+#include "KernelLib.h"
+
+/*!
+ * Writes a ScreenieScene to a file in a background thread, so the user can
+ * continue editing the scene while it is being saved.
+ *
+ * A snapshot of the scene is taken when writing is started: changes made
+ * in the meantime are not written. The snapshot is written to a temporary
+ * file, which then replaces the actual file. So a failed write leaves the
+ * previous file untouched.
+ *
+ * The scene is marked as unmodified when the write succeeds, unless it
+ * was changed while being written.
+ */
+class ScreenieSceneWriter : public QObject
+{
+    Q_OBJECT
+public:
+    KERNEL_API explicit ScreenieSceneWriter(QObject *parent = 0);
+    KERNEL_API virtual ~ScreenieSceneWriter();
+
+    /*!
+     * Starts writing a snapshot of the \p screenieScene to \p filePath and returns
+     * immediately. Waits for a previous write to finish first.
+     *
+     * \param preview
+     *        the preview which is stored along with the scene; see ScreenieSceneDao#setPreview(const QImage &)
+     * \sa #finished(bool, const QString &, ScreenieScene *)
+     */
+    KERNEL_API void write(ScreenieScene &screenieScene, const QString &filePath, const QImage &preview);
+
+    KERNEL_API bool isWriting() const;
+
+    /*!
+     * Blocks until the current write - if any - has finished. The
+     * #finished(bool, const QString &, ScreenieScene *) signal has been emitted when this
+     * method returns.
+     */
+    KERNEL_API void waitForFinished();
+
+signals:
+    /*!
+     * Emitted when writing to \p filePath has finished.
+     *
+     * \param ok
+     *        \c true if the scene has been written successfully; \c false else
+     * \param filePath
+     *        the path of the written file
+     * \param screenieScene
+     *        the scene which has been written; 0 if it has been destroyed in the meantime
+     */
+    void finished(bool ok, const QString &filePath, ScreenieScene *screenieScene);
+
+private:
+    ScreenieSceneWriterPrivate *d;
+
+    void frenchConnection();
+
+private slots:
+    void handleWriteFinished();
+    void handleSceneChanged();
+    void handleSceneDestroyed();
+};
+
+#endif // SCREENIESCENEWRITER_H
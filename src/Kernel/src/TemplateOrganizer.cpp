@@ -1,5 +1,6 @@
 #include <QtCore/QtAlgorithms>
 #include <QtCore/QList>
+#include <QtCore/QSet>
 
 #include "../../Model/src/ScreenieScene.h"
 #include "../../Model/src/ScreenieTemplateModel.h"
@@ -61,6 +62,10 @@ void TemplateOrganizer::frenchConnection()
             this, SLOT(handleModelAdded(ScreenieModelInterface &)));
     connect(&d->screenieScene, SIGNAL(modelRemoved(ScreenieModelInterface &)),
             this, SLOT(handleModelRemoved(ScreenieModelInterface &)));
+    connect(&d->screenieScene, SIGNAL(modelsAdded(const QList<ScreenieModelInterface *> &)),
+            this, SLOT(handleModelsAdded(const QList<ScreenieModelInterface *> &)));
+    connect(&d->screenieScene, SIGNAL(modelsRemoved(const QList<ScreenieModelInterface *> &)),
+            this, SLOT(handleModelsRemoved(const QList<ScreenieModelInterface *> &)));
 }
 
 // private slots
@@ -85,3 +90,23 @@ void TemplateOrganizer::handleModelRemoved(ScreenieModelInterface &screenieModel
         }
     }
 }
+
+void TemplateOrganizer::handleModelsAdded(const QList<ScreenieModelInterface *> &screenieModels)
+{
+    foreach (ScreenieModelInterface *screenieModel, screenieModels) {
+        handleModelAdded(*screenieModel);
+    }
+}
+
+void TemplateOrganizer::handleModelsRemoved(const QList<ScreenieModelInterface *> &screenieModels)
+{
+    // single pass over the templates, instead of one lookup per removed model
+    QSet<ScreenieModelInterface *> removedModels = screenieModels.toSet();
+    QList<ScreenieTemplateModel *> remainingTemplates;
+    foreach (ScreenieTemplateModel *screenieTemplateModel, d->templates) {
+        if (!removedModels.contains(screenieTemplateModel)) {
+            remainingTemplates.append(screenieTemplateModel);
+        }
+    }
+    d->templates = remainingTemplates;
+}
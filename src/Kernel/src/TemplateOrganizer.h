@@ -33,6 +33,8 @@ private:
 private slots:
     void handleModelAdded(ScreenieModelInterface &screenieModel);
     void handleModelRemoved(ScreenieModelInterface &screenieModel);
+    void handleModelsAdded(const QList<ScreenieModelInterface *> &screenieModels);
+    void handleModelsRemoved(const QList<ScreenieModelInterface *> &screenieModels);
 };
 
 #endif // TEMPLATEORGANIZER_H
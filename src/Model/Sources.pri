@@ -2,6 +2,7 @@ DEPENDPATH += $$PWD/../Utils/src \
               $$PWD/GeneratedFiles \
               $$PWD/src/Dao \
               $$PWD/src/Dao/Xml \
+              $$PWD/src/Dao/Package \
               $$PWD/src
 
 HEADERS += $$PWD/src/ModelLib.h \
@@ -11,6 +12,7 @@ HEADERS += $$PWD/src/ModelLib.h \
            $$PWD/src/ScreenieModelInterface.h \
            $$PWD/src/SceneLimits.h \
            $$PWD/src/ScreenieImageModel.h \
+           $$PWD/src/ImagePayload.h \
            $$PWD/src/ScreenieTemplateModel.h \
            $$PWD/src/ScreenieScene.h \
            $$PWD/src/SceneDefaults.h \
@@ -19,24 +21,31 @@ HEADERS += $$PWD/src/ModelLib.h \
            $$PWD/src/Dao/ScreenieImageModelDao.h \
            $$PWD/src/Dao/ScreenieTemplateModelDao.h \
            $$PWD/src/Dao/ScreenieSceneSerializer.h \
+           $$PWD/src/Dao/ScreenieSceneDaoFactory.h \
            $$PWD/src/Dao/Xml/XmlScreenieSceneDao.h \           
            $$PWD/src/Dao/Xml/XmlScreenieFilePathModelDao.h \
            $$PWD/src/Dao/Xml/XmlScreenieTemplateModelDao.h \
            $$PWD/src/Dao/Xml/AbstractXmlScreenieModelDao.h \
            $$PWD/src/Dao/Xml/XmlScreenieImageModelDao.h \
-           $$PWD/src/Dao/Xml/XmlScreenieSceneSerializer.h
+           $$PWD/src/Dao/Xml/XmlScreenieSceneSerializer.h \
+           $$PWD/src/Dao/Package/PackageScreenieSceneDao.h \
+           $$PWD/src/Dao/Package/PackageScreenieSceneSerializer.h
 
 SOURCES += $$PWD/src/AbstractScreenieModel.cpp \
            $$PWD/src/DefaultScreenieModel.cpp \
            $$PWD/src/ScreenieFilePathModel.cpp \
            $$PWD/src/SceneLimits.cpp \
            $$PWD/src/ScreenieImageModel.cpp \
+           $$PWD/src/ImagePayload.cpp \
            $$PWD/src/ScreenieTemplateModel.cpp \
            $$PWD/src/ScreenieScene.cpp \
            $$PWD/src/SceneDefaults.cpp \
+           $$PWD/src/Dao/ScreenieSceneDaoFactory.cpp \
            $$PWD/src/Dao/Xml/XmlScreenieSceneDao.cpp \
            $$PWD/src/Dao/Xml/XmlScreenieFilePathModelDao.cpp \
            $$PWD/src/Dao/Xml/XmlScreenieTemplateModelDao.cpp \
            $$PWD/src/Dao/Xml/AbstractXmlScreenieModelDao.cpp \
            $$PWD/src/Dao/Xml/XmlScreenieImageModelDao.cpp \
-           $$PWD/src/Dao/Xml/XmlScreenieSceneSerializer.cpp
+           $$PWD/src/Dao/Xml/XmlScreenieSceneSerializer.cpp \
+           $$PWD/src/Dao/Package/PackageScreenieSceneDao.cpp \
+           $$PWD/src/Dao/Package/PackageScreenieSceneSerializer.cpp
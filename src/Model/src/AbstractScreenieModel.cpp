@@ -280,3 +280,13 @@ QImage AbstractScreenieModel::fitToMaximumSize(const QImage &image) const
     }
     return result;
 }
+
+QSize AbstractScreenieModel::fitToMaximumSize(const QSize &size) const
+{
+    QSize result = size;
+    QSize maximumImageSize = Settings::getInstance().getMaximumImageSize();
+    if (size.width() > maximumImageSize.width() || size.height() > maximumImageSize.height()) {
+        result.scale(maximumImageSize, Qt::KeepAspectRatio);
+    }
+    return result;
+}
@@ -72,6 +72,11 @@ public:
 protected:
     QImage fitToMaximumSize(const QImage &image) const;
 
+    /*!
+     * Returns the size an image of the given \p size would have after #fitToMaximumSize(const QImage &).
+     */
+    QSize fitToMaximumSize(const QSize &size) const;
+
 private:
     AbstractScreenieModelPrivate *d;
 };
@@ -0,0 +1,563 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <cstring>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QHash>
+#include <QtCore/QSize>
+#include <QtCore/QPointF>
+#include <QtCore/QBitArray>
+#include <QtCore/QIODevice>
+#include <QtCore/QFile>
+#include <QtCore/QBuffer>
+#include <QtCore/QDataStream>
+#include <QtGui/QColor>
+#include <QtGui/QImage>
+
+#include "../../../../Utils/src/Version.h"
+#include "../../../../Utils/src/SizeFitter.h"
+#include "../../ScreenieScene.h"
+#include "../../ScreenieModelInterface.h"
+#include "../../ScreenieFilePathModel.h"
+#include "../../ScreenieImageModel.h"
+#include "../../ScreenieTemplateModel.h"
+#include "PackageScreenieSceneDao.h"
+
+class PackageScreenieSceneDaoPrivate
+{
+public:
+    PackageScreenieSceneDaoPrivate(QIODevice &theDevice, PackageScreenieSceneDao::ImageEncoding theImageEncoding)
+        : device(theDevice),
+          imageEncoding(theImageEncoding)
+    {}
+
+    /*
+     * The type of the models, as stored in the scene header.
+     */
+    enum ModelType {
+        FilePathModel = 0,
+        ImageModel = 1,
+        TemplateModel = 2
+    };
+
+    /*
+     * An entry in the image index.
+     */
+    struct ImageEntry {
+        qint64 offset;
+        qint64 length;
+        QSize size;
+    };
+
+    QIODevice &device;
+    PackageScreenieSceneDao::ImageEncoding imageEncoding;
+    Version version;
+    QImage preview;
+
+    /*
+     * Raw images are stored as ARGB32 pixels, optionally 'compressed' with the
+     * fastest compression level. A null image is stored as an empty blob.
+     */
+    static QByteArray encodeRawImage(const QImage &image, bool compressed)
+    {
+        QByteArray result;
+        if (!image.isNull()) {
+            const QImage argbImage = image.convertToFormat(QImage::Format_ARGB32);
+            const char *bits = reinterpret_cast<const char *>(argbImage.bits());
+            if (compressed) {
+                result = qCompress(QByteArray::fromRawData(bits, argbImage.byteCount()), 1);
+            } else {
+                result = QByteArray(bits, argbImage.byteCount());
+            }
+        }
+        return result;
+    }
+
+    static QImage decodeRawImage(const QByteArray &blob, const QSize &size, bool compressed)
+    {
+        QImage result;
+        // the size is read from the file: the pixel count must not overflow
+        if (!blob.isEmpty() && size.isValid() && static_cast<qint64>(size.width()) * size.height() * 4 <= MaxRawImageLength) {
+            QByteArray pixels = compressed ? qUncompress(blob) : blob;
+            if (pixels.size() == size.width() * size.height() * 4) {
+                // 32 bit scanlines are never padded
+                result = QImage(size, QImage::Format_ARGB32);
+                std::memcpy(result.bits(), pixels.constData(), pixels.size());
+            }
+        }
+        return result;
+    }
+
+    static const char Magic[];
+    static const int MagicLength;
+    static const quint32 FormatVersion;
+    // magic, format version, index offset, image count
+    static const qint64 HeaderLength;
+    static const QDataStream::Version DataStreamVersion;
+    static const qint64 MaxRawImageLength;
+};
+
+const char PackageScreenieSceneDaoPrivate::Magic[] = "\x89SCRNPKG";
+const int PackageScreenieSceneDaoPrivate::MagicLength = 8;
+const quint32 PackageScreenieSceneDaoPrivate::FormatVersion = 3;
+const qint64 PackageScreenieSceneDaoPrivate::HeaderLength = 8 + 4 + 8 + 4;
+const QDataStream::Version PackageScreenieSceneDaoPrivate::DataStreamVersion = QDataStream::Qt_4_6;
+// the maximum length in bytes of the pixels of a raw image, which must fit into a QByteArray
+const qint64 PackageScreenieSceneDaoPrivate::MaxRawImageLength = 0x7fffffff;
+
+// public
+
+PackageScreenieSceneDao::PackageScreenieSceneDao(QIODevice &device, ImageEncoding imageEncoding)
+    : d(new PackageScreenieSceneDaoPrivate(device, imageEncoding))
+{
+}
+
+PackageScreenieSceneDao::~PackageScreenieSceneDao()
+{
+    delete d;
+}
+
+bool PackageScreenieSceneDao::write(const ScreenieScene &screenieScene)
+{
+    return write(screenieScene, ScreenieSceneSerializer::FullScene);
+}
+
+bool PackageScreenieSceneDao::write(const ScreenieScene &screenieScene, ScreenieSceneSerializer::Mode mode)
+{
+    bool result;
+    if (d->device.open(QIODevice::WriteOnly)) {
+        result = !d->device.isSequential();
+        if (result) {
+            QDataStream dataStream(&d->device);
+            dataStream.setVersion(PackageScreenieSceneDaoPrivate::DataStreamVersion);
+            // the index offset is not yet known: the header is completed at the end
+            writeHeader(dataStream, 0, 0);
+
+            // preview, right after the header (format version 2)
+            QByteArray preview;
+            if (!d->preview.isNull()) {
+                QBuffer buffer(&preview);
+                buffer.open(QIODevice::WriteOnly);
+                d->preview.save(&buffer, "PNG");
+            }
+            dataStream << preview;
+            // image encoding (format version 3)
+            dataStream << static_cast<quint8>(d->imageEncoding);
+
+            // scene header
+            QList<ScreenieModelInterface *> screenieModels;
+            if (mode == ScreenieSceneSerializer::SelectedItems) {
+                screenieModels = screenieScene.getSelectedModels();
+            } else {
+                screenieModels = screenieScene.getModels();
+            }
+            QList<const ScreenieImageModel *> imageModels;
+            dataStream << d->version.toString();
+            dataStream << screenieScene.isTemplate();
+            dataStream << screenieScene.isBackgroundEnabled();
+            dataStream << screenieScene.getBackgroundColor();
+            dataStream << static_cast<quint32>(screenieModels.count());
+            foreach (const ScreenieModelInterface *screenieModel, screenieModels) {
+                const ScreenieFilePathModel *screenieFilePathModel = qobject_cast<const ScreenieFilePathModel *>(screenieModel);
+                const ScreenieImageModel *screenieImageModel = qobject_cast<const ScreenieImageModel *>(screenieModel);
+                const ScreenieTemplateModel *screenieTemplateModel = qobject_cast<const ScreenieTemplateModel *>(screenieModel);
+                if (screenieFilePathModel != 0) {
+                    dataStream << static_cast<quint8>(PackageScreenieSceneDaoPrivate::FilePathModel);
+                    writeModel(dataStream, *screenieModel);
+                    dataStream << screenieFilePathModel->getFilePath();
+                } else if (screenieImageModel != 0) {
+                    dataStream << static_cast<quint8>(PackageScreenieSceneDaoPrivate::ImageModel);
+                    writeModel(dataStream, *screenieModel);
+                    // the index of the image blob
+                    dataStream << static_cast<quint32>(imageModels.count());
+                    imageModels.append(screenieImageModel);
+                } else if (screenieTemplateModel != 0) {
+                    SizeFitter &sizeFitter = screenieTemplateModel->getSizeFitter();
+                    dataStream << static_cast<quint8>(PackageScreenieSceneDaoPrivate::TemplateModel);
+                    writeModel(dataStream, *screenieModel);
+                    dataStream << static_cast<qint32>(screenieTemplateModel->getOrder());
+                    dataStream << static_cast<qint32>(sizeFitter.getFitMode());
+                    dataStream << sizeFitter.getFitOptions();
+                    dataStream << sizeFitter.getTargetSize();
+                } else {
+#ifdef DEBUG
+                    qCritical("PackageScreenieSceneDao::write: UNSUPPORTED: %s", screenieModel->metaObject()->className());
+#endif
+                    result = false;
+                }
+            }
+
+            // image blobs; modified images are encoded concurrently first
+            if (d->imageEncoding == PngEncoding) {
+                ScreenieImageModel::encodeImages(imageModels);
+            }
+            QList<PackageScreenieSceneDaoPrivate::ImageEntry> imageEntries;
+            // identical images share a single blob
+            QHash<QByteArray, PackageScreenieSceneDaoPrivate::ImageEntry> writtenImages;
+            foreach (const ScreenieImageModel *screenieImageModel, imageModels) {
+                PackageScreenieSceneDaoPrivate::ImageEntry imageEntry;
+                QByteArray imageKey;
+                QImage image;
+                if (d->imageEncoding == PngEncoding) {
+                    imageKey = screenieImageModel->getImageHash();
+                } else {
+                    // shared images are shallow copies of each other
+                    image = screenieImageModel->getImage();
+                    imageKey = QByteArray::number(image.cacheKey());
+                }
+                if (writtenImages.contains(imageKey)) {
+                    imageEntry = writtenImages.value(imageKey);
+                } else {
+                    QByteArray blob;
+                    if (d->imageEncoding == PngEncoding) {
+                        // deferred images are written without decoding them
+                        blob = screenieImageModel->getEncodedImage();
+                        imageEntry.size = screenieImageModel->getSize();
+                    } else {
+                        blob = PackageScreenieSceneDaoPrivate::encodeRawImage(image, d->imageEncoding == RawEncoding);
+                        imageEntry.size = image.size();
+                    }
+                    imageEntry.offset = d->device.pos();
+                    // null images are written as empty blobs, which are read as null images again
+                    result = result && d->device.write(blob) == blob.size();
+                    imageEntry.length = d->device.pos() - imageEntry.offset;
+                    writtenImages.insert(imageKey, imageEntry);
+                }
+                imageEntries.append(imageEntry);
+            }
+
+            // image index
+            qint64 indexOffset = d->device.pos();
+            foreach (const PackageScreenieSceneDaoPrivate::ImageEntry &imageEntry, imageEntries) {
+                dataStream << imageEntry.offset << imageEntry.length << imageEntry.size;
+            }
+
+            result = result && d->device.seek(0);
+            if (result) {
+                writeHeader(dataStream, indexOffset, imageEntries.count());
+            }
+            result = result && dataStream.status() == QDataStream::Ok;
+        }
+        d->device.close();
+    } else {
+        result = false;
+    }
+    return result;
+}
+
+ScreenieScene *PackageScreenieSceneDao::read() const
+{
+    ScreenieScene *result;
+    if (d->device.open(QIODevice::ReadOnly)) {
+        QByteArray data;
+        uchar *mappedData = 0;
+        QSharedPointer<QFile> mappedFile;
+        QFile *file = qobject_cast<QFile *>(&d->device);
+        QBuffer *buffer = qobject_cast<QBuffer *>(&d->device);
+        if (file != 0 && file->size() > 0) {
+            // the images refer to the mapped data until they are decoded or written:
+            // the file is mapped by a separate QFile which is kept open as long as
+            // any image refers to it, and unmapped upon its destruction
+            mappedFile = QSharedPointer<QFile>(new QFile(file->fileName()));
+            if (mappedFile->open(QIODevice::ReadOnly)) {
+                mappedData = mappedFile->map(0, mappedFile->size());
+            }
+            if (mappedData == 0) {
+                mappedFile.clear();
+            }
+        }
+        if (mappedData != 0) {
+            // no copy: the data is valid as long as the file is mapped
+            data = QByteArray::fromRawData(reinterpret_cast<const char *>(mappedData), mappedFile->size());
+        } else if (buffer != 0) {
+            // no copy either: the data is implicitly shared
+            data = buffer->data();
+        } else {
+            data = d->device.readAll();
+        }
+        result = readScreenieScene(data, mappedFile);
+        d->device.close();
+    } else {
+        result = 0;
+    }
+    return result;
+}
+
+void PackageScreenieSceneDao::setPreview(const QImage &preview)
+{
+    d->preview = preview;
+}
+
+QImage PackageScreenieSceneDao::readPreview() const
+{
+    QImage result;
+    if (d->device.open(QIODevice::ReadOnly)) {
+        // only the header and the preview are read
+        QDataStream dataStream(&d->device);
+        dataStream.setVersion(PackageScreenieSceneDaoPrivate::DataStreamVersion);
+        QByteArray magic(PackageScreenieSceneDaoPrivate::MagicLength, '\0');
+        quint32 formatVersion;
+        qint64 indexOffset;
+        quint32 imageCount;
+        dataStream.readRawData(magic.data(), PackageScreenieSceneDaoPrivate::MagicLength);
+        dataStream >> formatVersion >> indexOffset >> imageCount;
+        if (dataStream.status() == QDataStream::Ok &&
+            magic == QByteArray(PackageScreenieSceneDaoPrivate::Magic, PackageScreenieSceneDaoPrivate::MagicLength) &&
+            formatVersion >= 2 && formatVersion <= PackageScreenieSceneDaoPrivate::FormatVersion) {
+            QByteArray preview;
+            dataStream >> preview;
+            if (dataStream.status() == QDataStream::Ok && !preview.isEmpty()) {
+                result.loadFromData(preview, "PNG");
+            }
+        }
+        d->device.close();
+    }
+    return result;
+}
+
+bool PackageScreenieSceneDao::isPackage(QIODevice &device)
+{
+    bool result;
+    bool wasOpen = device.isOpen();
+    if (wasOpen || device.open(QIODevice::ReadOnly)) {
+        QByteArray magic = device.peek(PackageScreenieSceneDaoPrivate::MagicLength);
+        result = magic == QByteArray(PackageScreenieSceneDaoPrivate::Magic, PackageScreenieSceneDaoPrivate::MagicLength);
+        if (!wasOpen) {
+            device.close();
+        }
+    } else {
+        result = false;
+    }
+    return result;
+}
+
+// private
+
+void PackageScreenieSceneDao::writeHeader(QDataStream &dataStream, qint64 indexOffset, int imageCount)
+{
+    dataStream.writeRawData(PackageScreenieSceneDaoPrivate::Magic, PackageScreenieSceneDaoPrivate::MagicLength);
+    dataStream << PackageScreenieSceneDaoPrivate::FormatVersion;
+    dataStream << indexOffset;
+    dataStream << static_cast<quint32>(imageCount);
+}
+
+void PackageScreenieSceneDao::writeModel(QDataStream &dataStream, const ScreenieModelInterface &screenieModel)
+{
+    dataStream << screenieModel.getPosition();
+    dataStream << static_cast<double>(screenieModel.getDistance());
+    dataStream << static_cast<qint32>(screenieModel.getRotation());
+    dataStream << screenieModel.isReflectionEnabled();
+    dataStream << static_cast<qint32>(screenieModel.getReflectionOffset());
+    dataStream << static_cast<qint32>(screenieModel.getReflectionOpacity());
+}
+
+ScreenieScene *PackageScreenieSceneDao::readScreenieScene(const QByteArray &data, const QSharedPointer<QFile> &mappedFile) const
+{
+    ScreenieScene *result;
+    QByteArray buffered = data;
+    QBuffer buffer(&buffered);
+    buffer.open(QIODevice::ReadOnly);
+    QDataStream dataStream(&buffer);
+    dataStream.setVersion(PackageScreenieSceneDaoPrivate::DataStreamVersion);
+
+    // header
+    QByteArray magic(PackageScreenieSceneDaoPrivate::MagicLength, '\0');
+    quint32 formatVersion;
+    qint64 indexOffset;
+    quint32 imageCount;
+    dataStream.readRawData(magic.data(), PackageScreenieSceneDaoPrivate::MagicLength);
+    dataStream >> formatVersion >> indexOffset >> imageCount;
+    bool ok = dataStream.status() == QDataStream::Ok &&
+              magic == QByteArray(PackageScreenieSceneDaoPrivate::Magic, PackageScreenieSceneDaoPrivate::MagicLength) &&
+              formatVersion <= PackageScreenieSceneDaoPrivate::FormatVersion &&
+              indexOffset >= PackageScreenieSceneDaoPrivate::HeaderLength && indexOffset <= data.size();
+
+    // image index
+    QList<PackageScreenieSceneDaoPrivate::ImageEntry> imageEntries;
+    PackageScreenieSceneDao::ImageEncoding imageEncoding = PackageScreenieSceneDao::PngEncoding;
+    if (ok) {
+        ok = buffer.seek(indexOffset);
+        for (quint32 i = 0; ok && i < imageCount; ++i) {
+            PackageScreenieSceneDaoPrivate::ImageEntry imageEntry;
+            dataStream >> imageEntry.offset >> imageEntry.length >> imageEntry.size;
+            // the blob must lie between the header and the index, which lies within the
+            // data; offset + length is not calculated, as it might overflow
+            ok = dataStream.status() == QDataStream::Ok &&
+                 imageEntry.offset >= PackageScreenieSceneDaoPrivate::HeaderLength &&
+                 imageEntry.offset <= indexOffset &&
+                 imageEntry.length >= 0 &&
+                 imageEntry.length <= indexOffset - imageEntry.offset;
+            imageEntries.append(imageEntry);
+        }
+        ok = ok && buffer.seek(PackageScreenieSceneDaoPrivate::HeaderLength);
+        if (ok && formatVersion >= 2) {
+            // skip the preview
+            quint32 previewLength;
+            dataStream >> previewLength;
+            ok = dataStream.status() == QDataStream::Ok;
+            if (ok && previewLength != 0xffffffff) {
+                ok = dataStream.skipRawData(previewLength) == static_cast<int>(previewLength);
+            }
+        }
+        if (ok && formatVersion >= 3) {
+            quint8 encoding;
+            dataStream >> encoding;
+            imageEncoding = static_cast<PackageScreenieSceneDao::ImageEncoding>(encoding);
+            ok = dataStream.status() == QDataStream::Ok &&
+                 (imageEncoding == PackageScreenieSceneDao::PngEncoding || imageEncoding == PackageScreenieSceneDao::RawEncoding ||
+                  imageEncoding == PackageScreenieSceneDao::UncompressedEncoding);
+        }
+    }
+
+    // scene header
+    if (ok) {
+        result = new ScreenieScene();
+        QString versionString;
+        bool isTemplate;
+        bool backgroundEnabled;
+        QColor backgroundColor;
+        quint32 modelCount;
+        dataStream >> versionString >> isTemplate >> backgroundEnabled >> backgroundColor >> modelCount;
+        Version documentVersion(versionString);
+        if (documentVersion < d->version) {
+            /*!\todo Convert file to current version */
+#ifdef DEBUG
+            qDebug("PackageScreenieSceneDao::readScreenieScene: CONVERSION NEEDED, document version: %s, app version: %s", qPrintable(documentVersion.toString()), qPrintable(d->version.toString()));
+#endif
+        }
+        result->setTemplate(isTemplate);
+        result->setBackgroundEnabled(backgroundEnabled);
+        result->setBackgroundColor(backgroundColor);
+
+        ok = dataStream.status() == QDataStream::Ok;
+        for (quint32 i = 0; ok && i < modelCount; ++i) {
+            quint8 modelType;
+            dataStream >> modelType;
+            ScreenieModelInterface *screenieModel;
+            switch (modelType) {
+            case PackageScreenieSceneDaoPrivate::FilePathModel:
+            {
+                ScreenieFilePathModel *screenieFilePathModel = new ScreenieFilePathModel();
+                QString filePath;
+                ok = readModel(dataStream, *screenieFilePathModel);
+                dataStream >> filePath;
+                screenieFilePathModel->setFilePath(filePath);
+                screenieModel = screenieFilePathModel;
+                break;
+            }
+            case PackageScreenieSceneDaoPrivate::ImageModel:
+            {
+                ScreenieImageModel *screenieImageModel = new ScreenieImageModel();
+                quint32 imageIndex;
+                ok = readModel(dataStream, *screenieImageModel);
+                dataStream >> imageIndex;
+                ok = ok && imageIndex < static_cast<quint32>(imageEntries.count());
+                if (ok) {
+                    const PackageScreenieSceneDaoPrivate::ImageEntry &imageEntry = imageEntries.at(imageIndex);
+                    if (imageEncoding == PngEncoding) {
+                        // the blob is only decoded once the image is actually needed
+                        if (!mappedFile.isNull()) {
+                            // no copy: the image keeps the file mapped
+                            QByteArray encodedImage = QByteArray::fromRawData(data.constData() + imageEntry.offset, imageEntry.length);
+                            screenieImageModel->setEncodedImage(encodedImage, imageEntry.size, mappedFile);
+                        } else {
+                            // the data is released after reading
+                            QByteArray encodedImage(data.constData() + imageEntry.offset, imageEntry.length);
+                            screenieImageModel->setEncodedImage(encodedImage, imageEntry.size);
+                        }
+                    } else {
+                        QByteArray blob = QByteArray::fromRawData(data.constData() + imageEntry.offset, imageEntry.length);
+                        QImage image = PackageScreenieSceneDaoPrivate::decodeRawImage(blob, imageEntry.size, imageEncoding == RawEncoding);
+                        screenieImageModel->setImage(image);
+                        // an empty blob is a null image, anything else must decode
+                        ok = !image.isNull() || blob.isEmpty();
+                    }
+                }
+                screenieModel = screenieImageModel;
+                break;
+            }
+            case PackageScreenieSceneDaoPrivate::TemplateModel:
+            {
+                ScreenieTemplateModel *screenieTemplateModel = new ScreenieTemplateModel();
+                SizeFitter &sizeFitter = screenieTemplateModel->getSizeFitter();
+                qint32 order;
+                qint32 fitMode;
+                QBitArray fitOptions;
+                QSize targetSize;
+                ok = readModel(dataStream, *screenieTemplateModel);
+                dataStream >> order >> fitMode >> fitOptions >> targetSize;
+                screenieTemplateModel->setOrder(order);
+                sizeFitter.setFitMode(static_cast<SizeFitter::FitMode>(fitMode));
+                sizeFitter.setFitOptions(fitOptions);
+                sizeFitter.setTargetSize(targetSize);
+                screenieModel = screenieTemplateModel;
+                break;
+            }
+            default:
+#ifdef DEBUG
+                qCritical("PackageScreenieSceneDao::readScreenieScene: UNSUPPORTED model type: %d", modelType);
+#endif
+                screenieModel = 0;
+                ok = false;
+                break;
+            }
+            ok = ok && dataStream.status() == QDataStream::Ok;
+            if (ok) {
+                result->addModel(screenieModel);
+            } else {
+                delete screenieModel;
+            }
+        }
+
+        if (ok) {
+            result->setModified(false);
+        } else {
+            delete result;
+            result = 0;
+        }
+    } else {
+        result = 0;
+    }
+    return result;
+}
+
+bool PackageScreenieSceneDao::readModel(QDataStream &dataStream, ScreenieModelInterface &screenieModel) const
+{
+    QPointF position;
+    double distance;
+    qint32 rotation;
+    bool reflectionEnabled;
+    qint32 reflectionOffset;
+    qint32 reflectionOpacity;
+    dataStream >> position >> distance >> rotation >> reflectionEnabled >> reflectionOffset >> reflectionOpacity;
+    bool result = dataStream.status() == QDataStream::Ok;
+    if (result) {
+        screenieModel.setPosition(position);
+        screenieModel.setDistance(distance);
+        screenieModel.setRotation(rotation);
+        screenieModel.setReflectionEnabled(reflectionEnabled);
+        screenieModel.setReflectionOffset(reflectionOffset);
+        screenieModel.setReflectionOpacity(reflectionOpacity);
+    }
+    return result;
+}
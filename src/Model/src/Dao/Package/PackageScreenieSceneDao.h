@@ -0,0 +1,101 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef PACKAGESCREENIESCENEDAO_H
+#define PACKAGESCREENIESCENEDAO_H
+
+#include <QtCore/QSharedPointer>
+
+class QIODevice;
+class QFile;
+class QByteArray;
+class QDataStream;
+class QImage;
+
+#include "../../ModelLib.h"
+#include "../ScreenieSceneDao.h"
+#include "../ScreenieSceneSerializer.h"
+
+class ScreenieScene;
+class ScreenieModelInterface;
+class PackageScreenieSceneDaoPrivate;
+
+/*!
+ * This Data Access Object (DAO) implements a binary \em package persistence,
+ * as an alternative to the XML persistence for large scenes. The package consists of:
+ *
+ * - a fixed size header: magic bytes, format version and the position of the image index
+ * - the preview: a small PNG rendering of the scene (since format version 2)
+ * - the image encoding of the image blobs (since format version 3)
+ * - the scene header: the scene properties and all models, as QDataStream
+ * - the image blobs: the encoded (PNG) images, stored as is - or the raw pixels
+ * - the image index: offset, length and dimension of each image blob
+ *
+ * The layout of the entire scene is hence known without touching the image data,
+ * and each image can be decoded independently. When reading from a QFile the
+ * file is memory-mapped.
+ *
+ * Implementation note: writing requires a random-access device, as the
+ * header is completed once all image blobs have been written.
+ *
+ * \sa XmlScreenieSceneDao
+ */
+class PackageScreenieSceneDao : public ScreenieSceneDao
+{
+public:
+    /*!
+     * Defines how images are stored in the package upon writing. Reading supports
+     * both encodings.
+     */
+    enum ImageEncoding
+    {
+        /*! PNG: compact, but (re-)encoding modified images is costly */
+        PngEncoding = 0,
+        /*! Raw ARGB32 pixels, lightly compressed: fast, but larger; meant for transfers */
+        RawEncoding = 1,
+        /*! Raw ARGB32 pixels, uncompressed: for transfers in memory */
+        UncompressedEncoding = 2
+    };
+
+    MODEL_API explicit PackageScreenieSceneDao(QIODevice &device, ImageEncoding imageEncoding = PngEncoding);
+    MODEL_API virtual ~PackageScreenieSceneDao();
+
+    MODEL_API virtual bool write(const ScreenieScene &screenieScene);
+    MODEL_API virtual bool write(const ScreenieScene &screenieScene, ScreenieSceneSerializer::Mode mode);
+    MODEL_API virtual ScreenieScene *read() const;
+    MODEL_API virtual void setPreview(const QImage &preview);
+    MODEL_API virtual QImage readPreview() const;
+
+    /*!
+     * Returns whether the \p device contains a package, by checking the magic bytes.
+     * The \p device is opened (and closed again) if necessary.
+     */
+    MODEL_API static bool isPackage(QIODevice &device);
+
+private:
+    PackageScreenieSceneDaoPrivate *d;
+
+    void writeHeader(QDataStream &dataStream, qint64 indexOffset, int imageCount);
+    void writeModel(QDataStream &dataStream, const ScreenieModelInterface &screenieModel);
+    ScreenieScene *readScreenieScene(const QByteArray &data, const QSharedPointer<QFile> &mappedFile) const;
+    bool readModel(QDataStream &dataStream, ScreenieModelInterface &screenieModel) const;
+};
+
+#endif // PACKAGESCREENIESCENEDAO_H
@@ -0,0 +1,70 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QtCore/QByteArray>
+#include <QtCore/QBuffer>
+
+#include "../../ScreenieScene.h"
+#include "PackageScreenieSceneDao.h"
+#include "PackageScreenieSceneSerializer.h"
+
+class PackageScreenieSceneSerializerPrivate
+{
+public:
+    PackageScreenieSceneSerializerPrivate(PackageScreenieSceneDao::ImageEncoding theImageEncoding)
+        : imageEncoding(theImageEncoding)
+    {}
+
+    PackageScreenieSceneDao::ImageEncoding imageEncoding;
+};
+
+// public
+
+PackageScreenieSceneSerializer::PackageScreenieSceneSerializer(PackageScreenieSceneDao::ImageEncoding imageEncoding)
+    : d(new PackageScreenieSceneSerializerPrivate(imageEncoding))
+{
+}
+
+PackageScreenieSceneSerializer::~PackageScreenieSceneSerializer()
+{
+    delete d;
+}
+
+QByteArray PackageScreenieSceneSerializer::serialize(const ScreenieScene &screenieScene, Mode mode)
+{
+    QByteArray result;
+    bool ok;
+    QBuffer buffer(&result);
+    PackageScreenieSceneDao screenieSceneDao(buffer, d->imageEncoding);
+    ok = screenieSceneDao.write(screenieScene, mode);
+    if (!ok) {
+        result.resize(0);
+    }
+    return result;
+}
+
+ScreenieScene *PackageScreenieSceneSerializer::deserialize(QByteArray &data) const
+{
+    ScreenieScene *result;
+    QBuffer buffer(&data);
+    PackageScreenieSceneDao screenieSceneDao(buffer);
+    result = screenieSceneDao.read();
+    return result;
+}
@@ -0,0 +1,55 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef PACKAGESCREENIESCENESERIALIZER_H
+#define PACKAGESCREENIESCENESERIALIZER_H
+
+#include "../../ModelLib.h"
+#include "../ScreenieSceneSerializer.h"
+#include "PackageScreenieSceneDao.h"
+
+class PackageScreenieSceneSerializerPrivate;
+
+/*!
+ * Serializes ScreenieScene instances into the binary package format, with
+ * raw image pixels instead of PNG data. Much faster than the XmlScreenieSceneSerializer,
+ * which encodes images as base64 PNG, for transfers between application instances.
+ *
+ * \sa PackageScreenieSceneDao
+ */
+class PackageScreenieSceneSerializer : public ScreenieSceneSerializer
+{
+public:
+    /*!
+     * \param imageEncoding
+     *        the PackageScreenieSceneDao#ImageEncoding used for serializing; deserializing
+     *        supports all encodings
+     */
+    MODEL_API explicit PackageScreenieSceneSerializer(PackageScreenieSceneDao::ImageEncoding imageEncoding = PackageScreenieSceneDao::RawEncoding);
+    MODEL_API virtual ~PackageScreenieSceneSerializer();
+
+    MODEL_API virtual QByteArray serialize(const ScreenieScene &screenieScene, Mode mode);
+    MODEL_API virtual ScreenieScene *deserialize(QByteArray &data) const;
+
+private:
+    PackageScreenieSceneSerializerPrivate *d;
+};
+
+#endif // PACKAGESCREENIESCENESERIALIZER_H
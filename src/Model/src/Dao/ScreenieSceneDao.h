@@ -21,6 +21,8 @@
 #ifndef SCREENIESCENEDAO_H
 #define SCREENIESCENEDAO_H
 
+class QImage;
+
 class ScreenieScene;
 
 class ScreenieSceneDao
@@ -47,6 +49,26 @@ public:
      *         must be \c deleted by the caller; may be 0 on error
      */
     virtual ScreenieScene *read() const = 0;
+
+    /*!
+     * Sets the \p preview image which is stored along with the ScreenieScene upon the
+     * next #write(const ScreenieScene &). The preview is stored at the beginning of the
+     * persistence stream, so it can be read without reading the entire scene.
+     *
+     * \param preview
+     *        a small rendering of the scene; a null QImage stores no preview
+     * \sa #readPreview()
+     */
+    virtual void setPreview(const QImage &preview) = 0;
+
+    /*!
+     * Reads only the preview image, which requires reading just the beginning of
+     * the persistence stream.
+     *
+     * \return the preview image; a null QImage if no preview has been stored or on error
+     * \sa #setPreview(const QImage &)
+     */
+    virtual QImage readPreview() const = 0;
 };
 
 #endif // SCREENIESCENEDAO_H
@@ -0,0 +1,67 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QString>
+
+#include "../../../Utils/src/FileUtils.h"
+#include "../../../Utils/src/Settings.h"
+#include "Xml/XmlScreenieSceneDao.h"
+#include "Package/PackageScreenieSceneDao.h"
+#include "ScreenieSceneDao.h"
+#include "ScreenieSceneDaoFactory.h"
+
+// public
+
+ScreenieSceneDao *ScreenieSceneDaoFactory::createReader(QFile &file)
+{
+    ScreenieSceneDao *result;
+    if (PackageScreenieSceneDao::isPackage(file)) {
+        result = new PackageScreenieSceneDao(file);
+    } else {
+        result = new XmlScreenieSceneDao(file);
+    }
+    return result;
+}
+
+ScreenieSceneDao *ScreenieSceneDaoFactory::createWriter(QFile &file)
+{
+    return createWriter(file, file.fileName());
+}
+
+ScreenieSceneDao *ScreenieSceneDaoFactory::createWriter(QFile &file, const QString &filePath)
+{
+    return createWriter(file, filePath, Settings::getInstance().isCompressSceneFilesEnabled());
+}
+
+ScreenieSceneDao *ScreenieSceneDaoFactory::createWriter(QFile &file, const QString &filePath, bool compressed)
+{
+    ScreenieSceneDao *result;
+    if (QFileInfo(filePath).suffix().compare(FileUtils::PackageExtension, Qt::CaseInsensitive) == 0) {
+        // the package images are compressed already
+        result = new PackageScreenieSceneDao(file);
+    } else {
+        XmlScreenieSceneDao *xmlScreenieSceneDao = new XmlScreenieSceneDao(file);
+        xmlScreenieSceneDao->setCompressionEnabled(compressed);
+        result = xmlScreenieSceneDao;
+    }
+    return result;
+}
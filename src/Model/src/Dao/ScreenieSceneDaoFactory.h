@@ -0,0 +1,75 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef SCREENIESCENEDAOFACTORY_H
+#define SCREENIESCENEDAOFACTORY_H
+
+class QFile;
+class QString;
+
+#include "../ModelLib.h"
+
+class ScreenieSceneDao;
+
+/*!
+ * Creates the ScreenieSceneDao which matches the format of a given file.
+ */
+class ScreenieSceneDaoFactory
+{
+public:
+    /*!
+     * Creates the ScreenieSceneDao for reading from the \p file, according to the
+     * \em content of the \p file.
+     *
+     * \return the ScreenieSceneDao; must be \c deleted by the caller
+     */
+    MODEL_API static ScreenieSceneDao *createReader(QFile &file);
+
+    /*!
+     * Creates the ScreenieSceneDao for writing to the \p file, according to the
+     * \em file extension of the \p file: the package format is used for
+     * FileUtils#PackageExtension, the XML format otherwise.
+     *
+     * \return the ScreenieSceneDao; must be \c deleted by the caller
+     */
+    MODEL_API static ScreenieSceneDao *createWriter(QFile &file);
+
+    /*!
+     * Creates the ScreenieSceneDao for writing to the \p file, according to the
+     * file extension of the \p filePath instead. Useful for writing to temporary
+     * files which replace the actual \p filePath afterwards.
+     *
+     * XML files are compressed according to Settings#isCompressSceneFilesEnabled().
+     *
+     * \return the ScreenieSceneDao; must be \c deleted by the caller
+     */
+    MODEL_API static ScreenieSceneDao *createWriter(QFile &file, const QString &filePath);
+
+    /*!
+     * Creates the ScreenieSceneDao for writing to the \p file, according to the
+     * file extension of the \p filePath; XML files are \p compressed as requested.
+     * Does not access the Settings and may hence be called from worker threads.
+     *
+     * \return the ScreenieSceneDao; must be \c deleted by the caller
+     */
+    MODEL_API static ScreenieSceneDao *createWriter(QFile &file, const QString &filePath, bool compressed);
+};
+
+#endif // SCREENIESCENEDAOFACTORY_H
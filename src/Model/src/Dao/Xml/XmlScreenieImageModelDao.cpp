@@ -22,19 +22,41 @@
 #include <QtCore/QBuffer>
 #include <QtCore/QFile>
 #include <QtCore/QByteArray>
+#include <QtCore/QStringRef>
+#include <QtCore/QtGlobal>
 #include <QtCore/QXmlStreamWriter>
+#include <QtCore/QXmlStreamReader>
+#include <QtCore/QSize>
+#include <QtCore/QHash>
+#include <QtCore/QtAlgorithms>
+#include <QtCore/QXmlStreamAttributes>
 #include <QtGui/QImage>
+#include <QtGui/QImageReader>
 
+#include "../../../../Utils/src/Base64Decoder.h"
 #include "../../ScreenieImageModel.h"
 #include "XmlScreenieImageModelDao.h"
 
 class XmlScreenieImageModelDaoPrivate
 {
 public:
+    // the number of image bytes per CDATA section; a multiple of 3,
+    // so the base64 encoded chunks need no padding
+    static const int ChunkSize;
+
+    ~XmlScreenieImageModelDaoPrivate()
+    {
+        qDeleteAll(resources);
+    }
+
     const ScreenieImageModel *writeModel;
     ScreenieImageModel *readModel;
+    // the image resources by id; the models merely hold the shared image data
+    QHash<QString, ScreenieImageModel *> resources;
 };
 
+const int XmlScreenieImageModelDaoPrivate::ChunkSize = 3 * 16 * 1024;
+
 //  public
 
 XmlScreenieImageModelDao::XmlScreenieImageModelDao(QXmlStreamWriter &xmlStreamWriter)
@@ -73,6 +95,39 @@ ScreenieImageModel *XmlScreenieImageModelDao::read()
     return result;
 }
 
+bool XmlScreenieImageModelDao::writeResource(const ScreenieImageModel &screenieImageModel)
+{
+    bool result = true;
+    QXmlStreamWriter *streamWriter = getStreamWriter();
+    streamWriter->writeStartElement("image");
+    {
+        streamWriter->writeAttribute("id", QString::fromLatin1(screenieImageModel.getImageHash()));
+        // deferred images are written without decoding them
+        writeImageData(screenieImageModel.getEncodedImage());
+    }
+    streamWriter->writeEndElement();
+    return result;
+}
+
+bool XmlScreenieImageModelDao::readResource()
+{
+    bool result;
+    QXmlStreamReader *streamReader = getStreamReader();
+    QString id = streamReader->attributes().value("id").toString();
+    QByteArray png = readImageData();
+    QSize size = readImageSize(png);
+    if (!id.isEmpty() && size.isValid()) {
+        ScreenieImageModel *resource = new ScreenieImageModel();
+        resource->setEncodedImage(png, size);
+        delete d->resources.value(id);
+        d->resources.insert(id, resource);
+        result = true;
+    } else {
+        result = false;
+    }
+    return result;
+}
+
 // protected
 
 bool XmlScreenieImageModelDao::writeSpecific()
@@ -81,13 +136,8 @@ bool XmlScreenieImageModelDao::writeSpecific()
     QXmlStreamWriter *streamWriter = getStreamWriter();
     streamWriter->writeStartElement("img");
     {
-        QBuffer buffer;
-        buffer.open(QIODevice::WriteOnly);
-        d->writeModel->getImage().save(&buffer, "PNG");
-        buffer.close();
-        QByteArray byteArray = buffer.buffer();
-        QString data = QString(byteArray.toBase64());
-        streamWriter->writeCDATA(data);
+        // the image data itself is written once per scene, as image resource
+        streamWriter->writeAttribute("ref", QString::fromLatin1(d->writeModel->getImageHash()));
     }
     streamWriter->writeEndElement();
     return result;
@@ -95,26 +145,80 @@ bool XmlScreenieImageModelDao::writeSpecific()
 
 bool XmlScreenieImageModelDao::readSpecific()
 {
-    bool result = true;
+    bool result;
     QXmlStreamReader *streamReader = getStreamReader();
     streamReader->readNextStartElement();
 
-    QString data = streamReader->readElementText();
-    if (!data.isEmpty()) {
-        QByteArray str;
-        str.append(data);
-        QByteArray png = QByteArray::fromBase64(str);
-
-        QImage image;
-        result = image.loadFromData(png, "PNG");
-        if (result && !image.isNull()) {
-            d->readModel->setImage(image);
+    QString ref = streamReader->attributes().value("ref").toString();
+    if (!ref.isEmpty()) {
+        ScreenieImageModel *resource = d->resources.value(ref);
+        if (resource != 0) {
+            // duplicate images share their image data
+            d->readModel->shareImage(*resource);
+            result = true;
         } else {
+#ifdef DEBUG
+            qCritical("XmlScreenieImageModelDao::readSpecific: UNKNOWN image resource: %s", qPrintable(ref));
+#endif
             result = false;
         }
+        streamReader->skipCurrentElement();
     } else {
-        result = false;
+        // documents without image resources contain the image data in place
+        QByteArray png = readImageData();
+        QSize size = readImageSize(png);
+        if (size.isValid()) {
+            d->readModel->setEncodedImage(png, size);
+            result = true;
+        } else {
+            result = false;
+        }
     }
     return result;
 }
 
+// private
+
+void XmlScreenieImageModelDao::writeImageData(const QByteArray &png)
+{
+    QXmlStreamWriter *streamWriter = getStreamWriter();
+    // the base64 text is written in chunks (adjacent CDATA sections), instead
+    // of converting the entire image into base64 and UTF-16 at once
+    for (int offset = 0; offset < png.size(); offset += XmlScreenieImageModelDaoPrivate::ChunkSize) {
+        int length = qMin(XmlScreenieImageModelDaoPrivate::ChunkSize, png.size() - offset);
+        QByteArray chunk = QByteArray::fromRawData(png.constData() + offset, length);
+        streamWriter->writeCDATA(QString::fromLatin1(chunk.toBase64()));
+    }
+}
+
+QByteArray XmlScreenieImageModelDao::readImageData()
+{
+    QByteArray result;
+    QXmlStreamReader *streamReader = getStreamReader();
+    // the base64 text is decoded as it is read, straight from the reader's buffer
+    Base64Decoder base64Decoder(result);
+    QXmlStreamReader::TokenType tokenType;
+    while ((tokenType = streamReader->readNext()) != QXmlStreamReader::EndElement && !streamReader->hasError()) {
+        if (tokenType == QXmlStreamReader::Characters) {
+            QStringRef text = streamReader->text();
+            base64Decoder.decode(text.unicode(), text.size());
+        }
+    }
+    // the data is kept: release the decoding headroom
+    result.squeeze();
+    return result;
+}
+
+QSize XmlScreenieImageModelDao::readImageSize(QByteArray &png)
+{
+    QSize result;
+    if (!png.isEmpty()) {
+        // only the image header is read here: the image is decoded on demand
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::ReadOnly);
+        QImageReader imageReader(&buffer, "PNG");
+        result = imageReader.size();
+        buffer.close();
+    }
+    return result;
+}
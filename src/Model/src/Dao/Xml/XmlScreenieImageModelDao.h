@@ -23,6 +23,8 @@
 
 class QXmlStreamWriter;
 class QXmlStreamReader;
+class QByteArray;
+class QSize;
 
 #include "../ScreenieImageModelDao.h"
 #include "AbstractXmlScreenieModelDao.h"
@@ -43,12 +45,31 @@ public:
     virtual bool write(const ScreenieImageModel &screeniePixmapModel);
     virtual ScreenieImageModel *read();
 
+    /*!
+     * Writes the image of the \p screenieImageModel as shared image resource,
+     * identified by its hash. Models written afterwards refer to their image
+     * resource instead of containing the image data themselves.
+     *
+     * \sa ScreenieImageModel#getImageHash()
+     */
+    bool writeResource(const ScreenieImageModel &screenieImageModel);
+
+    /*!
+     * Reads the current image resource element. Models which refer to the image
+     * resource share its image data.
+     */
+    bool readResource();
+
 protected:
     virtual bool writeSpecific();
     virtual bool readSpecific();
 
 private:
     XmlScreenieImageModelDaoPrivate *d;
+
+    void writeImageData(const QByteArray &png);
+    QByteArray readImageData();
+    static QSize readImageSize(QByteArray &png);
 };
 
 #endif // XMLSCREENIEIMAGEMODELDAO_H
@@ -19,13 +19,19 @@
  */
 
 #include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QSet>
+#include <QtCore/QtAlgorithms>
 #include <QtCore/QStringRef>
 #include <QtCore/QIODevice>
+#include <QtCore/QBuffer>
 #include <QtCore/QXmlStreamWriter>
 #include <QtCore/QXmlStreamReader>
 #include <QtGui/QColor>
+#include <QtGui/QImage>
 
 #include "../../../../Utils/src/Version.h"
+#include "../../../../Utils/src/CompressedDevice.h"
 #include "../../ScreenieScene.h"
 #include "../../ScreenieModelInterface.h"
 #include "../../ScreenieFilePathModel.h"
@@ -45,8 +51,10 @@
 class XmlScreenieSceneDaoPrivate
 {
 public:
-    XmlScreenieSceneDaoPrivate(QIODevice &theDevice)
+    XmlScreenieSceneDaoPrivate(QIODevice &theDevice, XmlScreenieSceneDao::ImageDecoding theImageDecoding)
         : device(theDevice),
+          imageDecoding(theImageDecoding),
+          compressionEnabled(false),
           streamWriter(0),
           streamReader(0),
           screenieFilePathModelDao(0),
@@ -55,16 +63,19 @@ public:
     {}
 
     QIODevice &device;
+    XmlScreenieSceneDao::ImageDecoding imageDecoding;
+    bool compressionEnabled;
+    QImage preview;
     Version version;
     QXmlStreamWriter *streamWriter;
     QXmlStreamReader *streamReader;
     ScreenieFilePathModelDao *screenieFilePathModelDao;
-    ScreenieImageModelDao *screeniePixmapModelDao;
+    XmlScreenieImageModelDao *screeniePixmapModelDao;
     ScreenieTemplateModelDao *screenieTemplateModelDao;
 };
 
-XmlScreenieSceneDao::XmlScreenieSceneDao(QIODevice &device)
-    : d(new XmlScreenieSceneDaoPrivate(device))
+XmlScreenieSceneDao::XmlScreenieSceneDao(QIODevice &device, ImageDecoding imageDecoding)
+    : d(new XmlScreenieSceneDaoPrivate(device, imageDecoding))
 {
 }
 
@@ -83,34 +94,41 @@ ScreenieScene *XmlScreenieSceneDao::read() const
 {
     ScreenieScene *result = 0;
     if (d->device.open(QIODevice::ReadOnly)) {
-        d->streamReader = new QXmlStreamReader(&d->device);
-        QXmlStreamReader::TokenType tokenType;
-        while ((tokenType = d->streamReader->readNext()) != QXmlStreamReader::EndDocument) {
-            if (tokenType == QXmlStreamReader::StartElement) {
-                if (d->streamReader->name() == "screeniescene") {
-                    QXmlStreamAttributes sceneAttributes = d->streamReader->attributes();
-                    QString versionString = sceneAttributes.value("version").toString();
-                    Version documentVersion(versionString);
-                    if (documentVersion < d->version) {
-                        /*!\todo Convert file to current version */
+        CompressedDevice compressedDevice(d->device);
+        QIODevice *xmlDevice = getReadDevice(compressedDevice);
+        if (xmlDevice != 0) {
+            d->streamReader = new QXmlStreamReader(xmlDevice);
+            QXmlStreamReader::TokenType tokenType;
+            while ((tokenType = d->streamReader->readNext()) != QXmlStreamReader::EndDocument) {
+                if (tokenType == QXmlStreamReader::StartElement) {
+                    if (d->streamReader->name() == "screeniescene") {
+                        QXmlStreamAttributes sceneAttributes = d->streamReader->attributes();
+                        QString versionString = sceneAttributes.value("version").toString();
+                        Version documentVersion(versionString);
+                        if (documentVersion < d->version) {
+                            /*!\todo Convert file to current version */
 #ifdef DEBUG
-                        qDebug("XmlScreenieSceneDao::read: CONVERSION NEEDED, document version: %s, app version: %s", qPrintable(documentVersion.toString()), qPrintable(d->version.toString()));
+                            qDebug("XmlScreenieSceneDao::read: CONVERSION NEEDED, document version: %s, app version: %s", qPrintable(documentVersion.toString()), qPrintable(d->version.toString()));
 #endif
+                        }
+                        result = readScreenieScene();
+                    } else {
+                        result = 0;
                     }
-                    result = readScreenieScene();
-                } else {
-                    result = 0;
                 }
-            }
-            if (d->streamReader->error() != QXmlStreamReader::NoError) {
-                // Note: we do not deal yet with QXmlStreamReader::PrematureEndOfDocumentError: disk files
-                // should always be complete XML
+                if (d->streamReader->error() != QXmlStreamReader::NoError) {
+                    // Note: we do not deal yet with QXmlStreamReader::PrematureEndOfDocumentError: disk files
+                    // should always be complete XML
 #ifdef DEBUG
-                qDebug("XmlScreenieSceneDao::read: error: %d", d->streamReader->error());
+                    qDebug("XmlScreenieSceneDao::read: error: %d", d->streamReader->error());
 #endif
-                result = 0;
-                break;
+                    result = 0;
+                    break;
+                }
             }
+            compressedDevice.close();
+        } else {
+            result = 0;
         }
         d->device.close();
     } else {
@@ -120,15 +138,56 @@ ScreenieScene *XmlScreenieSceneDao::read() const
     return result;
 }
 
+void XmlScreenieSceneDao::setPreview(const QImage &preview)
+{
+    d->preview = preview;
+}
+
+QImage XmlScreenieSceneDao::readPreview() const
+{
+    QImage result;
+    if (d->device.open(QIODevice::ReadOnly)) {
+        CompressedDevice compressedDevice(d->device);
+        QIODevice *xmlDevice = getReadDevice(compressedDevice);
+        if (xmlDevice != 0) {
+            // the preview is the first element of the scene: parsing stops right after it
+            QXmlStreamReader streamReader(xmlDevice);
+            if (streamReader.readNextStartElement() && streamReader.name() == "screeniescene" &&
+                streamReader.readNextStartElement() && streamReader.name() == "preview") {
+                QByteArray png = QByteArray::fromBase64(streamReader.readElementText().toLatin1());
+                result.loadFromData(png, "PNG");
+            }
+            compressedDevice.close();
+        }
+        d->device.close();
+    }
+    return result;
+}
+
 bool XmlScreenieSceneDao::write(const ScreenieScene &screenieScene, ScreenieSceneSerializer::Mode mode)
 {
     bool result;
     if (d->device.open(QIODevice::WriteOnly)) {
-        d->streamWriter = new QXmlStreamWriter(&d->device);
-        d->streamWriter->setAutoFormatting(true);
-        d->streamWriter->writeStartDocument();
-        result = writeScreenieScene(screenieScene, mode);
-        d->streamWriter->writeEndDocument();
+        CompressedDevice compressedDevice(d->device);
+        QIODevice *xmlDevice;
+        if (d->compressionEnabled) {
+            xmlDevice = compressedDevice.open(QIODevice::WriteOnly) ? &compressedDevice : 0;
+        } else {
+            xmlDevice = &d->device;
+        }
+        if (xmlDevice != 0) {
+            d->streamWriter = new QXmlStreamWriter(xmlDevice);
+            d->streamWriter->setAutoFormatting(true);
+            d->streamWriter->writeStartDocument();
+            result = writeScreenieScene(screenieScene, mode);
+            d->streamWriter->writeEndDocument();
+            if (d->compressionEnabled) {
+                result = compressedDevice.finish() && result;
+                compressedDevice.close();
+            }
+        } else {
+            result = false;
+        }
         d->device.close();
     } else {
         result = false;
@@ -137,8 +196,30 @@ bool XmlScreenieSceneDao::write(const ScreenieScene &screenieScene, ScreenieScen
     return result;
 }
 
+void XmlScreenieSceneDao::setCompressionEnabled(bool enable)
+{
+    d->compressionEnabled = enable;
+}
+
+bool XmlScreenieSceneDao::isCompressionEnabled() const
+{
+    return d->compressionEnabled;
+}
+
 // private
 
+QIODevice *XmlScreenieSceneDao::getReadDevice(CompressedDevice &compressedDevice) const
+{
+    QIODevice *result;
+    // compressed files are decompressed block by block while parsing
+    if (CompressedDevice::isCompressed(d->device)) {
+        result = compressedDevice.open(QIODevice::ReadOnly) ? &compressedDevice : 0;
+    } else {
+        result = &d->device;
+    }
+    return result;
+}
+
 bool XmlScreenieSceneDao::writeScreenieScene(const ScreenieScene &screenieScene, ScreenieSceneSerializer::Mode mode)
 {
     bool result = true;
@@ -152,6 +233,7 @@ bool XmlScreenieSceneDao::writeScreenieScene(const ScreenieScene &screenieScene,
     {
         switch (mode) {
         case ScreenieSceneSerializer::FullScene:
+            writePreview();
             d->streamWriter->writeStartElement("background");
             {
                 QXmlStreamAttributes backgroundAttributes;
@@ -176,6 +258,18 @@ bool XmlScreenieSceneDao::writeScreenieScene(const ScreenieScene &screenieScene,
     return result;
 }
 
+void XmlScreenieSceneDao::writePreview()
+{
+    if (!d->preview.isNull()) {
+        QByteArray png;
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::WriteOnly);
+        if (d->preview.save(&buffer, "PNG")) {
+            d->streamWriter->writeTextElement("preview", QString::fromLatin1(png.toBase64()));
+        }
+    }
+}
+
 bool XmlScreenieSceneDao::writeScreenieModels(const ScreenieScene &screenieScene, ScreenieSceneSerializer::Mode mode)
 {
     bool result = true;
@@ -195,6 +289,19 @@ bool XmlScreenieSceneDao::writeScreenieModels(const ScreenieScene &screenieScene
         break;
     }
 
+    // encode the (modified) images concurrently, before writing them one by one
+    QList<const ScreenieImageModel *> screenieImageModels;
+    foreach (const ScreenieModelInterface *screenieModel, screenieModels) {
+        const ScreenieImageModel *screenieImageModel = qobject_cast<const ScreenieImageModel *>(screenieModel);
+        if (screenieImageModel != 0) {
+            screenieImageModels.append(screenieImageModel);
+        }
+    }
+    ScreenieImageModel::encodeImages(screenieImageModels);
+    if (screenieImageModels.count() > 0) {
+        result = writeImageResources(screenieImageModels);
+    }
+
     foreach (ScreenieModelInterface *screenieModel, screenieModels) {
         ScreenieFilePathModel *screenieFilePathModel = qobject_cast<ScreenieFilePathModel *>(screenieModel);
         if (screenieFilePathModel != 0) {
@@ -249,6 +356,26 @@ bool XmlScreenieSceneDao::writePixmapModel(const ScreenieImageModel &screeniePix
     return result;
 }
 
+bool XmlScreenieSceneDao::writeImageResources(const QList<const ScreenieImageModel *> &screenieImageModels)
+{
+    bool result = true;
+    if (d->screeniePixmapModelDao == 0) {
+        d->screeniePixmapModelDao = new XmlScreenieImageModelDao(*d->streamWriter);
+    }
+    // each distinct image is written once, the models refer to it by its hash
+    QSet<QByteArray> imageHashes;
+    d->streamWriter->writeStartElement("resources");
+    foreach (const ScreenieImageModel *screenieImageModel, screenieImageModels) {
+        QByteArray imageHash = screenieImageModel->getImageHash();
+        if (!imageHashes.contains(imageHash)) {
+            imageHashes.insert(imageHash);
+            result = d->screeniePixmapModelDao->writeResource(*screenieImageModel) && result;
+        }
+    }
+    d->streamWriter->writeEndElement();
+    return result;
+}
+
 bool XmlScreenieSceneDao::writeTemplateModel(const ScreenieTemplateModel &screenieTemplateModel)
 {
     bool result;
@@ -271,6 +398,9 @@ ScreenieScene *XmlScreenieSceneDao::readScreenieScene() const
     bool isTemplate = sceneAttributes.value("isTemplate") == "true" ? true : false;
     result->setTemplate(isTemplate);
     bool ok = true;
+    // the models are only added to the scene once all of them have been read
+    QList<ScreenieModelInterface *> screenieModels;
+    QList<ScreenieImageModel *> screenieImageModels;
     while (ok && d->streamReader->readNextStartElement()) {
 
         if (d->streamReader->name() == "background") {
@@ -280,24 +410,30 @@ ScreenieScene *XmlScreenieSceneDao::readScreenieScene() const
             QColor color(backgroundAttributes.value("bgcolor").toString());
             result->setBackgroundColor(color);
             d->streamReader->skipCurrentElement();
+        } else if (d->streamReader->name() == "preview") {
+            // only of interest to readPreview()
+            d->streamReader->skipCurrentElement();
+        } else if (d->streamReader->name() == "resources") {
+            ok = readImageResources();
         } else if (d->streamReader->name() == "filepathmodel") {
             ScreenieFilePathModel *filePathModel = readFilePathModel();
             if (filePathModel != 0) {
-                result->addModel(filePathModel);
+                screenieModels.append(filePathModel);
             } else {
                 ok = false;
             }
         } else if (d->streamReader->name() == "pixmapmodel") {
             ScreenieImageModel *pixmapModel = readPixmapModel();
             if (pixmapModel != 0) {
-                result->addModel(pixmapModel);
+                screenieModels.append(pixmapModel);
+                screenieImageModels.append(pixmapModel);
             } else {
                 ok = false;
             }
         } else if (d->streamReader->name() == "templatemodel") {
             ScreenieTemplateModel *templateModel = readTemplateModel();
             if (templateModel != 0) {
-                result->addModel(templateModel);
+                screenieModels.append(templateModel);
             } else {
                 ok = false;
             }
@@ -313,9 +449,18 @@ ScreenieScene *XmlScreenieSceneDao::readScreenieScene() const
 #ifdef DEBUG
         qDebug("XmlScreenieSceneDao::readScreenieScene: streamReader error: %d, ok: %d", d->streamReader->error(), ok);
 #endif
+    if (ok && d->imageDecoding == XmlScreenieSceneDao::ConcurrentDecoding) {
+        // as with deferred decoding, an image which fails to decode only affects
+        // its own model, which is left without an image: the scene is still read
+        ScreenieImageModel::readImages(screenieImageModels);
+    }
     if (ok) {
+        foreach (ScreenieModelInterface *screenieModel, screenieModels) {
+            result->addModel(screenieModel);
+        }
         result->setModified(false);
     } else {
+        qDeleteAll(screenieModels);
         // Note: we do not yet support QXmlStreamReader::PrematureEndOfDocumentError (no streaming support)
         delete result;
         result = 0;
@@ -345,6 +490,25 @@ ScreenieImageModel *XmlScreenieSceneDao::readPixmapModel() const
     return result;
 }
 
+bool XmlScreenieSceneDao::readImageResources() const
+{
+    bool result = true;
+    if (d->screeniePixmapModelDao == 0) {
+        d->screeniePixmapModelDao = new XmlScreenieImageModelDao(*d->streamReader);
+    }
+    while (result && d->streamReader->readNextStartElement()) {
+        if (d->streamReader->name() == "image") {
+            result = d->screeniePixmapModelDao->readResource();
+        } else {
+#ifdef DEBUG
+            qCritical("XmlScreenieSceneDao::readImageResources: UNSUPPORTED: %s", qPrintable(d->streamReader->name().toString()));
+#endif
+            d->streamReader->skipCurrentElement();
+        }
+    }
+    return result;
+}
+
 ScreenieTemplateModel *XmlScreenieSceneDao::readTemplateModel() const
 {
     ScreenieTemplateModel *result;
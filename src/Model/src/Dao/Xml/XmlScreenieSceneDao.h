@@ -22,14 +22,17 @@
 #define XMLSCREENIESCENEDAO_H
 
 #include <QtCore/QByteArray>
+#include <QtCore/QList>
 
 class QIODevice;
+class QImage;
 
 #include "../../ModelLib.h"
 #include "../ScreenieSceneDao.h"
 #include "../ScreenieSceneSerializer.h"
 
 class ScreenieScene;
+class CompressedDevice;
 class ScreenieFilePathModel;
 class ScreenieImageModel;
 class ScreenieTemplateModel;
@@ -43,26 +46,50 @@ class XmlScreenieSceneDaoPrivate;
 class XmlScreenieSceneDao : public ScreenieSceneDao
 {
 public:
-    MODEL_API explicit XmlScreenieSceneDao(QIODevice &device);
+    /*!
+     * Defines when the images of ScreenieImageModel instances are decoded upon reading.
+     */
+    enum ImageDecoding
+    {
+        /*! Images are decoded on demand, once they are needed */
+        DeferredDecoding,
+        /*! All images are decoded concurrently before #read() returns */
+        ConcurrentDecoding
+    };
+
+    MODEL_API explicit XmlScreenieSceneDao(QIODevice &device, ImageDecoding imageDecoding = DeferredDecoding);
     MODEL_API virtual ~XmlScreenieSceneDao();
 
     MODEL_API virtual bool write(const ScreenieScene &screenieScene);
     MODEL_API virtual ScreenieScene *read() const;
+    MODEL_API virtual void setPreview(const QImage &preview);
+    MODEL_API virtual QImage readPreview() const;
 
     MODEL_API virtual bool write(const ScreenieScene &screenieScene, ScreenieSceneSerializer::Mode mode);
 
+    /*!
+     * Enables writing the XML data compressed with a CompressedDevice; disabled by
+     * default. Reading detects compressed data automatically.
+     */
+    MODEL_API void setCompressionEnabled(bool enable);
+    MODEL_API bool isCompressionEnabled() const;
+
 private:
     XmlScreenieSceneDaoPrivate *d;
 
+    QIODevice *getReadDevice(CompressedDevice &compressedDevice) const;
     bool writeScreenieScene(const ScreenieScene &screenieScene, ScreenieSceneSerializer::Mode mode);
+    void writePreview();
     bool writeScreenieModels(const ScreenieScene &screenieScene, ScreenieSceneSerializer::Mode mode);
     bool writeFilePathModel(const ScreenieFilePathModel &screenieFilePathModel);
     bool writePixmapModel(const ScreenieImageModel &screeniePixmapModel);
+    bool writeImageResources(const QList<const ScreenieImageModel *> &screenieImageModels);
     bool writeTemplateModel(const ScreenieTemplateModel &screenieTemplateModel);
 
     ScreenieScene *readScreenieScene() const;
     ScreenieFilePathModel *readFilePathModel() const;
     ScreenieImageModel *readPixmapModel() const;
+    bool readImageResources() const;
     ScreenieTemplateModel *readTemplateModel() const;
 
     void cleanUp() const;
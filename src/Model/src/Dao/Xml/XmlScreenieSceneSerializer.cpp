@@ -63,7 +63,8 @@ ScreenieScene *XmlScreenieSceneSerializer::deserialize(QByteArray &data) const
 {
    ScreenieScene *result = 0;
    QBuffer buffer(&data);
-   XmlScreenieSceneDao screenieSceneDao(buffer);
+   // the deserialized scene is fully materialised, so decode its images right away
+   XmlScreenieSceneDao screenieSceneDao(buffer, XmlScreenieSceneDao::ConcurrentDecoding);
    result = screenieSceneDao.read();
    return result;
 }
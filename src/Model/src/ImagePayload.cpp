@@ -0,0 +1,118 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QtCore/QByteArray>
+#include <QtCore/QBuffer>
+#include <QtCore/QMutexLocker>
+#include <QtCore/QCryptographicHash>
+#include <QtCore/QFile>
+#include <QtGui/QImage>
+
+#include "ImagePayload.h"
+
+// public
+
+ImagePayload::ImagePayload(const QByteArray &theEncodedImage, const QSize &theSize)
+    : encodedImage(theEncodedImage),
+      decoded(false),
+      size(theSize)
+{
+}
+
+ImagePayload::ImagePayload(const QByteArray &theEncodedImage, const QSize &theSize, const QSharedPointer<QFile> &theMappedFile)
+    : encodedImage(theEncodedImage),
+      decoded(false),
+      size(theSize),
+      mappedFile(theMappedFile)
+{
+}
+
+ImagePayload::ImagePayload(const QImage &theImage)
+    : image(theImage),
+      decoded(true),
+      size(theImage.size())
+{
+}
+
+QSize ImagePayload::getSize() const
+{
+    return size;
+}
+
+QImage ImagePayload::getImage()
+{
+    QMutexLocker mutexLocker(&mutex);
+    if (!decoded) {
+        image.loadFromData(encodedImage, "PNG");
+        // also remember failed attempts
+        decoded = true;
+#ifdef DEBUG
+        if (image.isNull()) {
+            qDebug("ImagePayload::getImage: could not decode image, %d bytes", encodedImage.size());
+        }
+#endif
+    }
+    return image;
+}
+
+QByteArray ImagePayload::getEncodedImage()
+{
+    QMutexLocker mutexLocker(&mutex);
+    if (!mappedFile.isNull()) {
+        // deep copy: the file is unmapped once no payload refers to it anymore
+        encodedImage = QByteArray(encodedImage.constData(), encodedImage.size());
+        mappedFile.clear();
+    }
+    encode();
+    return encodedImage;
+}
+
+QByteArray ImagePayload::getHash()
+{
+    QMutexLocker mutexLocker(&mutex);
+    if (hash.isNull()) {
+        encode();
+        hash = QCryptographicHash::hash(encodedImage, QCryptographicHash::Sha1).toHex();
+    }
+    return hash;
+}
+
+bool ImagePayload::isDecoded() const
+{
+    QMutexLocker mutexLocker(&mutex);
+    return decoded;
+}
+
+bool ImagePayload::isHashed() const
+{
+    QMutexLocker mutexLocker(&mutex);
+    return !hash.isNull();
+}
+
+// private
+
+void ImagePayload::encode()
+{
+    if (encodedImage.isNull() && !image.isNull()) {
+        QBuffer buffer(&encodedImage);
+        buffer.open(QIODevice::WriteOnly);
+        image.save(&buffer, "PNG");
+    }
+}
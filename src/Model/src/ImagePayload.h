@@ -0,0 +1,121 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef IMAGEPAYLOAD_H
+#define IMAGEPAYLOAD_H
+
+#include <QtCore/QSharedData>
+#include <QtCore/QByteArray>
+#include <QtCore/QSize>
+#include <QtCore/QMutex>
+#include <QtCore/QSharedPointer>
+#include <QtGui/QImage>
+
+class QFile;
+
+/*!
+ * The image data of a ScreenieImageModel: the encoded (PNG) image, the decoded
+ * image or both. The missing representation is created on demand and then kept,
+ * so an image which has been read is not encoded again when written, and an image
+ * is only decoded when it is actually needed.
+ *
+ * ImagePayload instances are explicitly shared, for instance between copies of a
+ * model, and are thread-safe: decoding and encoding may happen in worker threads.
+ * A thread which requests the image while another thread is decoding it waits for
+ * the result instead of decoding the image a second time.
+ *
+ * Internal class.
+ */
+class ImagePayload : public QSharedData
+{
+public:
+    /*!
+     * Creates a \em deferred ImagePayload which is decoded on demand.
+     *
+     * \param encodedImage
+     *        the PNG encoded image
+     * \param size
+     *        the size of the encoded image
+     */
+    ImagePayload(const QByteArray &encodedImage, const QSize &size);
+
+    /*!
+     * Creates a \em deferred ImagePayload whose \p encodedImage refers to the memory
+     * mapped \p mappedFile, which is kept mapped as long as it is referred to.
+     *
+     * \param encodedImage
+     *        the PNG encoded image, typically created with QByteArray::fromRawData()
+     * \param size
+     *        the size of the encoded image
+     * \param mappedFile
+     *        the memory mapped file which contains the \p encodedImage
+     */
+    ImagePayload(const QByteArray &encodedImage, const QSize &size, const QSharedPointer<QFile> &mappedFile);
+
+    /*!
+     * Creates an ImagePayload which is encoded on demand.
+     */
+    explicit ImagePayload(const QImage &image);
+
+    /*!
+     * Returns the size of the image; the image is not decoded.
+     */
+    QSize getSize() const;
+
+    /*!
+     * Returns the decoded image, decoding it first if necessary.
+     *
+     * \return the decoded image; a \em null QImage if decoding failed
+     */
+    QImage getImage();
+
+    /*!
+     * Returns the PNG encoded image, encoding it first if necessary. An encoded image
+     * which refers to a mapped file is copied first, and the file is released: the
+     * encoded image is typically requested in order to save the scene, possibly
+     * replacing the mapped file.
+     */
+    QByteArray getEncodedImage();
+
+    /*!
+     * Returns the SHA-1 hash of the PNG encoded image (as hex string), encoding
+     * the image first if necessary. The hash identifies the image content.
+     */
+    QByteArray getHash();
+
+    bool isDecoded() const;
+    bool isHashed() const;
+
+private:
+    Q_DISABLE_COPY(ImagePayload)
+
+    mutable QMutex mutex;
+    QByteArray encodedImage;
+    QImage image;
+    bool decoded;
+    QSize size;
+    QByteArray hash;
+    QSharedPointer<QFile> mappedFile;
+
+    // the 'mutex' must be locked
+    void encode();
+};
+
+#endif // IMAGEPAYLOAD_H
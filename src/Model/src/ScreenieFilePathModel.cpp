@@ -20,11 +20,19 @@
 
 #include <QtCore/QSize>
 #include <QtCore/QString>
+#include <QtCore/QList>
+#include <QtCore/QPair>
 #include <QtCore/QDir>
+#include <QtCore/QFuture>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QtConcurrentRun>
 #include <QtGui/QImage>
+#include <QtGui/QImageReader>
 
 #include "../../Utils/src/SizeFitter.h"
 #include "../../Utils/src/PaintTools.h"
+#include "../../Utils/src/Settings.h"
+#include "../../Utils/src/ThumbnailCache.h"
 #include "ScreenieFilePathModel.h"
 
 class ScreenieFilePathModelPrivate
@@ -32,36 +40,72 @@ class ScreenieFilePathModelPrivate
 public:
     ScreenieFilePathModelPrivate(const QString &theFilePath, const SizeFitter *theSizeFitter)
         : valid(false),
+          placeholder(false),
+          reading(false),
           filePath(theFilePath),
-          sizeFitter(theSizeFitter)
+          sizeFitter(theSizeFitter != 0 ? new SizeFitter(*theSizeFitter) : 0)
     {}
 
     ScreenieFilePathModelPrivate(const ScreenieFilePathModelPrivate &other)
         : valid(other.valid),
+          placeholder(false),
+          reading(false),
           filePath(other.filePath),
-          image(other.image),
-          sizeFitter(other.sizeFitter)
+          // a placeholder is not copied: the copy reads the actual image itself
+          image(other.placeholder ? QImage() : other.image),
+          sizeFitter(other.sizeFitter != 0 ? new SizeFitter(*other.sizeFitter) : 0)
     {}
 
+    ~ScreenieFilePathModelPrivate()
+    {
+        delete sizeFitter;
+    }
+
     bool valid;
+    bool placeholder;
+    bool reading;
     QString filePath;
     QImage image;
-    const SizeFitter *sizeFitter;    
+    SizeFitter *sizeFitter;
+    QFutureWatcher<QImage> imageWatcher;
+
+    /*
+     * Reads the image from 'filePath' and scales it to 'fittedSize', if valid. Called
+     * in a worker thread.
+     */
+    static QImage readImage(const QString &filePath, const QSize &fittedSize, bool writeThumbnail)
+    {
+        QImage result;
+        QImageReader imageReader(filePath);
+        result = imageReader.read();
+        if (!result.isNull()) {
+            if (writeThumbnail) {
+                ThumbnailCache::writeThumbnail(filePath, result);
+            }
+            if (fittedSize.isValid() && result.size() != fittedSize) {
+                result = result.scaled(fittedSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+            }
+        }
+        return result;
+    }
 };
 
 ScreenieFilePathModel::ScreenieFilePathModel(const QString &filePath, const SizeFitter *sizeFitter)
     : d(new ScreenieFilePathModelPrivate(filePath, sizeFitter))
 {
+    frenchConnection();
 }
 
 ScreenieFilePathModel::ScreenieFilePathModel(const ScreenieFilePathModel &other)
     : AbstractScreenieModel(other),
       d(new ScreenieFilePathModelPrivate(*other.d))
 {
+    frenchConnection();
 }
 
 ScreenieFilePathModel::~ScreenieFilePathModel()
 {
+    // an ongoing read is not waited for: its result is simply discarded
     delete d;
 #ifdef DEBUG
     qDebug("ScreenieFilePathModel:~ScreenieFilePathModel: called.");
@@ -70,21 +114,47 @@ ScreenieFilePathModel::~ScreenieFilePathModel()
 
 const QImage &ScreenieFilePathModel::readImage() const
 {
-    d->image.load(d->filePath);
-    if (!d->image.isNull()) {
-        if (d->sizeFitter != 0) {
-            QSize fittedSize;
-            bool doResize = d->sizeFitter->fit(d->image.size(), fittedSize);
-            if (doResize) {
-                d->image = d->image.scaled(fittedSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    if (d->reading) {
+        d->imageWatcher.waitForFinished();
+        // notifies the observers about the actual image
+        const_cast<ScreenieFilePathModel *>(this)->handleImageRead();
+    } else if (d->image.isNull()) {
+        QImage image;
+        image.load(d->filePath);
+        if (!image.isNull()) {
+            QSize fittedSize = getFittedSize(image.size());
+            if (fittedSize != image.size()) {
+                image = image.scaled(fittedSize, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
             }
+        }
+        updateImage(image);
+    }
+    return d->image;
+}
+
+const QImage &ScreenieFilePathModel::requestImage() const
+{
+    if (d->image.isNull()) {
+        // only the image header is read here
+        QSize size = QImageReader(d->filePath).size();
+        if (size.isValid()) {
+            QSize fittedSize = getFittedSize(size);
+            QImage thumbnail = ThumbnailCache::readThumbnail(d->filePath);
+            if (!thumbnail.isNull()) {
+                d->image = thumbnail.scaled(fittedSize, Qt::IgnoreAspectRatio, Qt::FastTransformation);
+            } else {
+                d->image = PaintTools::createPlaceholderImage(fittedSize);
+            }
+            d->valid = true;
+            d->placeholder = true;
+            d->reading = true;
+            d->imageWatcher.setFuture(QtConcurrent::run(&ScreenieFilePathModelPrivate::readImage,
+                                                        d->filePath, fittedSize,
+                                                        Settings::getInstance().isWriteThumbnailsEnabled()));
         } else {
-            d->image = fitToMaximumSize(d->image);
+            // missing or unsupported file: creates the default image
+            readImage();
         }
-        d->valid = true;
-    } else {
-        d->image = PaintTools::createDefaultImage();
-        d->valid = false;
     }
     return d->image;
 }
@@ -95,8 +165,13 @@ QSize ScreenieFilePathModel::getSize() const
     if (!d->image.isNull()) {
         result = d->image.size();
     } else {
-        /*!\todo Optimisation: use Exiv2 (or http://www.sentex.net/~mwandel/jhead/) library to quickly read the image size from disk (EXIF data). */
-        result = readImage().size();
+        // try to read the size from the image header first
+        result = QImageReader(d->filePath).size();
+        if (result.isValid()) {
+            result = getFittedSize(result);
+        } else {
+            result = readImage().size();
+        }
     }
     return result;
 }
@@ -127,6 +202,9 @@ void ScreenieFilePathModel::setFilePath(const QString &filePath)
     if (d->filePath != filePath) {
         d->filePath = filePath;
         d->image = QImage();
+        d->placeholder = false;
+        // the result of an ongoing read is discarded
+        d->reading = false;
         emit filePathChanged(filePath);
     }
 }
@@ -136,5 +214,95 @@ QString ScreenieFilePathModel::getFilePath() const
     return d->filePath;
 }
 
+void ScreenieFilePathModel::reload()
+{
+    reload(QList<ScreenieFilePathModel *>() << this);
+}
+
+void ScreenieFilePathModel::reload(const QList<ScreenieFilePathModel *> &screenieFilePathModels)
+{
+    QSize size;
+    if (screenieFilePathModels.count() > 0) {
+        size = QImageReader(screenieFilePathModels.first()->getFilePath()).size();
+    }
+    if (size.isValid()) {
+        QString filePath = screenieFilePathModels.first()->getFilePath();
+        bool writeThumbnail = Settings::getInstance().isWriteThumbnailsEnabled();
+        // one read per distinct fitted size: models of the same size watch the same future
+        QList<QPair<QSize, QFuture<QImage> > > reads;
+        foreach (ScreenieFilePathModel *screenieFilePathModel, screenieFilePathModels) {
+            if (!screenieFilePathModel->d->image.isNull()) {
+                QSize fittedSize = screenieFilePathModel->getFittedSize(size);
+                QFuture<QImage> future;
+                bool found = false;
+                for (int i = 0; i < reads.count() && !found; ++i) {
+                    if (reads.at(i).first == fittedSize) {
+                        future = reads.at(i).second;
+                        found = true;
+                    }
+                }
+                if (!found) {
+                    future = QtConcurrent::run(&ScreenieFilePathModelPrivate::readImage,
+                                               filePath, fittedSize, writeThumbnail);
+                    reads.append(qMakePair(fittedSize, future));
+                    // the thumbnail is only written once
+                    writeThumbnail = false;
+                }
+                screenieFilePathModel->d->reading = true;
+                screenieFilePathModel->d->imageWatcher.setFuture(future);
+            }
+        }
+    }
+}
+
+// private
+
+void ScreenieFilePathModel::frenchConnection()
+{
+    connect(&d->imageWatcher, SIGNAL(finished()),
+            this, SLOT(handleImageRead()));
+}
 
+QSize ScreenieFilePathModel::getFittedSize(const QSize &size) const
+{
+    QSize result;
+    if (d->sizeFitter != 0) {
+        bool doResize = d->sizeFitter->fit(size, result);
+        if (!doResize) {
+            result = size;
+        }
+    } else {
+        result = fitToMaximumSize(size);
+    }
+    return result;
+}
 
+void ScreenieFilePathModel::updateImage(const QImage &image) const
+{
+    if (!image.isNull()) {
+        d->image = image;
+        d->valid = true;
+    } else {
+        d->image = PaintTools::createDefaultImage();
+        d->valid = false;
+    }
+    d->placeholder = false;
+}
+
+// private slots
+
+void ScreenieFilePathModel::handleImageRead()
+{
+    // the image might already have been taken by readImage(), or the
+    // file path might have changed in the meantime
+    if (d->reading && d->imageWatcher.isFinished()) {
+        d->reading = false;
+        QImage image = d->imageWatcher.result();
+        // when reloading fails - for instance because the file is still being
+        // written - the current image is kept
+        if (!image.isNull() || d->placeholder) {
+            updateImage(image);
+            emit imageChanged(d->image);
+        }
+    }
+}
@@ -24,6 +24,7 @@
 #include <QtCore/QObject>
 #include <QtCore/QSize>
 #include <QtCore/QString>
+#include <QtCore/QList>
 #include <QtGui/QImage>
 
 class QString;
@@ -44,21 +45,30 @@ class MODEL_API ScreenieFilePathModel : public AbstractScreenieModel
     Q_OBJECT
 public:
     /*!
-     * Creates this ScreenieFilePathModel. Call #readImage() after creation.
+     * Creates this ScreenieFilePathModel. Call #readImage() or #requestImage() after creation.
      *
      * \param filePath
      *        the file path to the image to be read
      * \param sizeFitter
-     *        if given the image is scaled with the \p sizeFitter; may be 0; ownership
-     *        remains with the caller
+     *        if given the image is scaled with the \p sizeFitter; may be 0; a copy
+     *        of the \p sizeFitter is stored, ownership remains with the caller
      *
      * \sa #readImage()
+     * \sa #requestImage()
      */
     explicit ScreenieFilePathModel(const QString &filePath = QString(), const SizeFitter *sizeFitter = 0);
     explicit ScreenieFilePathModel(const ScreenieFilePathModel &other);
     virtual ~ScreenieFilePathModel();
 
     virtual const QImage &readImage() const;
+
+    /*!
+     * Returns a placeholder - preferably the scaled thumbnail from the ThumbnailCache - while
+     * the image is read in a background thread.
+     *
+     * \sa ThumbnailCache
+     */
+    virtual const QImage &requestImage() const;
     virtual QSize getSize() const;
     virtual ScreenieModelInterface *copy() const;
     virtual bool isTemplate() const;
@@ -67,8 +77,33 @@ public:
     virtual QString getFilePath() const;
     virtual void setFilePath(const QString &filePath);
 
+    /*!
+     * Re-reads the image from disk in a background thread, for instance because the file
+     * has been modified. The current image remains valid until the new one has been read,
+     * in which case #imageChanged(const QImage &) is emitted.
+     *
+     * If the image is not read yet, or if the file is currently not readable, nothing happens.
+     */
+    void reload();
+
+    /*!
+     * Re-reads the images of the given \p screenieFilePathModels, which all refer to the
+     * same file, in a background thread. The file is only read once for all models which
+     * have the same image size.
+     *
+     * \sa #reload()
+     */
+    static void reload(const QList<ScreenieFilePathModel *> &screenieFilePathModels);
+
 private:
     ScreenieFilePathModelPrivate *d;
+
+    void frenchConnection();
+    QSize getFittedSize(const QSize &size) const;
+    void updateImage(const QImage &image) const;
+
+private slots:
+    void handleImageRead();
 };
 
 #endif // SCREENIEFILEPATHMODEL_H
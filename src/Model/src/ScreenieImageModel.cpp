@@ -20,31 +20,80 @@
 
 #include <QtCore/QSize>
 #include <QtCore/QString>
+#include <QtCore/QByteArray>
+#include <QtCore/QExplicitlySharedDataPointer>
+#include <QtCore/QFuture>
+#include <QtCore/QFutureWatcher>
+#include <QtCore/QList>
+#include <QtCore/QtConcurrentRun>
+#include <QtCore/QtConcurrentMap>
 #include <QtGui/QImage>
 
 #include "../../Utils/src/PaintTools.h"
+#include "ImagePayload.h"
 #include "ScreenieImageModel.h"
 
 class ScreenieImageModelPrivate
 {
 public:
-    ScreenieImageModelPrivate() {}
+    ScreenieImageModelPrivate(ImagePayload *theImagePayload)
+        : imagePayload(theImagePayload),
+          placeholder(false),
+          reading(false)
+    {}
+
     ScreenieImageModelPrivate(const ScreenieImageModelPrivate &other)
-        : image(other.image) {}
+        : imagePayload(other.imagePayload),
+          // a placeholder is not copied: the copy decodes the shared payload itself
+          image(other.placeholder ? QImage() : other.image),
+          placeholder(false),
+          reading(false)
+    {}
 
+    QExplicitlySharedDataPointer<ImagePayload> imagePayload;
     QImage image;
+    bool placeholder;
+    bool reading;
+    QFutureWatcher<QImage> imageWatcher;
+
+    /*
+     * Decodes the 'imagePayload'. Called in a worker thread.
+     */
+    static QImage decodeImage(QExplicitlySharedDataPointer<ImagePayload> imagePayload)
+    {
+        return imagePayload->getImage();
+    }
+
+    /*
+     * Decodes the 'imagePayload' in place. Called in a worker thread.
+     */
+    static void decodeImagePayload(QExplicitlySharedDataPointer<ImagePayload> &imagePayload)
+    {
+        imagePayload->getImage();
+    }
+
+    /*
+     * Encodes and hashes the 'imagePayload' in place. Called in a worker thread.
+     */
+    static void encodeImagePayload(QExplicitlySharedDataPointer<ImagePayload> &imagePayload)
+    {
+        imagePayload->getHash();
+    }
 };
 
 ScreenieImageModel::ScreenieImageModel(QImage image)
-    : d(new ScreenieImageModelPrivate())
+    : d(new ScreenieImageModelPrivate(0))
 {
     d->image = fitToMaximumSize(image);
+    d->imagePayload = new ImagePayload(d->image);
+    frenchConnection();
 }
 
 ScreenieImageModel::ScreenieImageModel(const ScreenieImageModel &other)
     : AbstractScreenieModel(other),
       d(new ScreenieImageModelPrivate(*other.d))
 {
+    frenchConnection();
 }
 
 ScreenieImageModel::~ScreenieImageModel()
@@ -57,12 +106,43 @@ ScreenieImageModel::~ScreenieImageModel()
 
 const QImage &ScreenieImageModel::readImage() const
 {
+    if (d->reading) {
+        d->imageWatcher.waitForFinished();
+        // notifies the observers about the actual image
+        const_cast<ScreenieImageModel *>(this)->handleImageRead();
+    } else if (d->image.isNull()) {
+        d->image = fitToMaximumSize(d->imagePayload->getImage());
+    }
+    return d->image;
+}
+
+const QImage &ScreenieImageModel::requestImage() const
+{
+    if (d->image.isNull()) {
+        if (d->imagePayload->isDecoded()) {
+            d->image = fitToMaximumSize(d->imagePayload->getImage());
+        } else {
+            QSize size = getSize();
+            if (size.isValid()) {
+                d->image = PaintTools::createPlaceholderImage(size);
+                d->placeholder = true;
+            }
+            d->reading = true;
+            d->imageWatcher.setFuture(QtConcurrent::run(&ScreenieImageModelPrivate::decodeImage, d->imagePayload));
+        }
+    }
     return d->image;
 }
 
 QSize ScreenieImageModel::getSize() const
 {
-    return d->image.size();
+    QSize result;
+    if (!d->image.isNull()) {
+        result = d->image.size();
+    } else {
+        result = fitToMaximumSize(d->imagePayload->getSize());
+    }
+    return result;
 }
 
 ScreenieModelInterface *ScreenieImageModel::copy() const
@@ -85,14 +165,97 @@ void ScreenieImageModel::setImage(QImage image)
 {
     if (d->image.cacheKey() != image.cacheKey()) {
         d->image = fitToMaximumSize(image);
+        d->imagePayload = new ImagePayload(d->image);
+        d->placeholder = false;
+        // the result of an ongoing decoding is discarded
+        d->reading = false;
         emit imageChanged(d->image);
     }
 }
 
 QImage ScreenieImageModel::getImage() const
 {
-    return d->image;
+    return readImage();
 }
 
+QByteArray ScreenieImageModel::getEncodedImage() const
+{
+    return d->imagePayload->getEncodedImage();
+}
 
+QByteArray ScreenieImageModel::getImageHash() const
+{
+    return d->imagePayload->getHash();
+}
+
+void ScreenieImageModel::shareImage(const ScreenieImageModel &other)
+{
+    d->imagePayload = other.d->imagePayload;
+    d->image = other.d->placeholder ? QImage() : other.d->image;
+    d->placeholder = false;
+    d->reading = false;
+}
 
+void ScreenieImageModel::setEncodedImage(const QByteArray &encodedImage, const QSize &size, const QSharedPointer<QFile> &mappedFile)
+{
+    d->imagePayload = new ImagePayload(encodedImage, size, mappedFile);
+    d->image = QImage();
+    d->placeholder = false;
+    d->reading = false;
+}
+
+bool ScreenieImageModel::readImages(const QList<ScreenieImageModel *> &screenieImageModels)
+{
+    bool result = true;
+    QList<QExplicitlySharedDataPointer<ImagePayload> > imagePayloads;
+    foreach (ScreenieImageModel *screenieImageModel, screenieImageModels) {
+        // shared payloads are only decoded once
+        const QExplicitlySharedDataPointer<ImagePayload> &imagePayload = screenieImageModel->d->imagePayload;
+        if (!imagePayload->isDecoded() && !imagePayloads.contains(imagePayload)) {
+            imagePayloads.append(imagePayload);
+        }
+    }
+    QtConcurrent::blockingMap(imagePayloads, &ScreenieImageModelPrivate::decodeImagePayload);
+    // the payloads are decoded by now: this merely fits the images
+    foreach (ScreenieImageModel *screenieImageModel, screenieImageModels) {
+        if (screenieImageModel->readImage().isNull()) {
+            result = false;
+        }
+    }
+    return result;
+}
+
+void ScreenieImageModel::encodeImages(const QList<const ScreenieImageModel *> &screenieImageModels)
+{
+    QList<QExplicitlySharedDataPointer<ImagePayload> > imagePayloads;
+    foreach (const ScreenieImageModel *screenieImageModel, screenieImageModels) {
+        // copies of a model share their payload, which is only encoded once
+        const QExplicitlySharedDataPointer<ImagePayload> &imagePayload = screenieImageModel->d->imagePayload;
+        if (!imagePayload->isHashed() && !imagePayloads.contains(imagePayload)) {
+            imagePayloads.append(imagePayload);
+        }
+    }
+    QtConcurrent::blockingMap(imagePayloads, &ScreenieImageModelPrivate::encodeImagePayload);
+}
+
+// private
+
+void ScreenieImageModel::frenchConnection()
+{
+    connect(&d->imageWatcher, SIGNAL(finished()),
+            this, SLOT(handleImageRead()));
+}
+
+// private slots
+
+void ScreenieImageModel::handleImageRead()
+{
+    // the image might already have been taken by readImage(), or
+    // replaced by setImage() in the meantime
+    if (d->reading && d->imageWatcher.isFinished()) {
+        d->reading = false;
+        d->image = fitToMaximumSize(d->imageWatcher.result());
+        d->placeholder = false;
+        emit imageChanged(d->image);
+    }
+}
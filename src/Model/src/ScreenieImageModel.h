@@ -22,13 +22,18 @@
 #define SCREENIEIMAGEMODEL_H
 
 #include <QtCore/QObject>
+#include <QtCore/QList>
 #include <QtCore/QSize>
 #include <QtCore/QString>
+#include <QtCore/QSharedPointer>
 #include <QtGui/QImage>
 
 #include "AbstractScreenieModel.h"
 #include "ModelLib.h"
 
+class QByteArray;
+class QFile;
+
 class ScreenieImageModelPrivate;
 
 /*!
@@ -54,6 +59,13 @@ public:
     virtual ~ScreenieImageModel();
 
     virtual const QImage &readImage() const;
+
+    /*!
+     * Returns a placeholder while a \em deferred image is decoded in a background thread.
+     *
+     * \sa #setEncodedImage(const QByteArray &, const QSize &)
+     */
+    virtual const QImage &requestImage() const;
     virtual QSize getSize() const;
     virtual ScreenieModelInterface *copy() const;
     virtual bool isTemplate() const;
@@ -62,8 +74,78 @@ public:
     QImage getImage() const;
     void setImage(QImage image);
 
+    /*!
+     * Returns the PNG encoded image. Deferred images are returned as is, without
+     * decoding and encoding them again.
+     *
+     * \return the PNG encoded image
+     */
+    QByteArray getEncodedImage() const;
+
+    /*!
+     * Returns the SHA-1 hash (as hex string) of the PNG encoded image, which identifies
+     * the image content. The hash is computed once per image.
+     *
+     * \sa #encodeImages(const QList<const ScreenieImageModel *> &)
+     */
+    QByteArray getImageHash() const;
+
+    /*!
+     * Shares the image of \p other: both models refer to the same encoded and
+     * decoded image data, which is decoded at most once. Like
+     * #setEncodedImage(const QByteArray &, const QSize &) meant to be called while
+     * reading the model.
+     */
+    void shareImage(const ScreenieImageModel &other);
+
+    /*!
+     * Sets a \em deferred image: the image is only decoded once it is actually
+     * needed, either by #readImage() or - in a background thread - by #requestImage().
+     * Meant to be called while reading the model: no #imageChanged(const QImage &)
+     * signal is emitted.
+     *
+     * \param encodedImage
+     *        the PNG encoded image
+     * \param size
+     *        the size of the encoded image
+     * \param mappedFile
+     *        the memory mapped file which the \p encodedImage refers to, if any; kept
+     *        mapped as long as the image refers to it
+     */
+    void setEncodedImage(const QByteArray &encodedImage, const QSize &size, const QSharedPointer<QFile> &mappedFile = QSharedPointer<QFile>());
+
+    /*!
+     * Decodes the \em deferred images of the given \p screenieImageModels concurrently,
+     * using the global thread pool. Blocks until all images have been decoded.
+     *
+     * \param screenieImageModels
+     *        the models whose images are to be decoded
+     * \return \c false if any of the images could not be decoded; \c true else
+     * \sa #setEncodedImage(const QByteArray &, const QSize &)
+     */
+    static bool readImages(const QList<ScreenieImageModel *> &screenieImageModels);
+
+    /*!
+     * Encodes and hashes the images of the given \p screenieImageModels concurrently,
+     * using the global thread pool, unless they have already been encoded. Blocks until
+     * all images have been encoded.
+     *
+     * The encoded image is kept until the image is changed, so writing a scene
+     * again only encodes the images which have been modified in the meantime.
+     *
+     * \param screenieImageModels
+     *        the models whose images are to be encoded
+     * \sa #getEncodedImage()
+     */
+    static void encodeImages(const QList<const ScreenieImageModel *> &screenieImageModels);
+
 private:
     ScreenieImageModelPrivate *d;
+
+    void frenchConnection();
+
+private slots:
+    void handleImageRead();
 };
 
 #endif // SCREENIEIMAGEMODEL_H
@@ -48,12 +48,22 @@ public:
      */
     virtual const QImage &readImage() const = 0;
 
+    /*!
+     * Returns the QImage without blocking: if the actual image is not available yet
+     * a placeholder with the same size is returned instead, for instance a scaled
+     * thumbnail. The actual image is then read in the background and #imageChanged(const QImage &)
+     * is emitted once it is available.
+     *
+     * \sa #readImage()
+     */
+    virtual const QImage &requestImage() const = 0;
+
     /*!
      * Returns the size of the image.
      *
-     * Implementation note: if #readImage has not yet been called the image is currently
-     * read from disk first, so it might be potentially expensive, but only for the first
-     * time (the image is stored in memory).
+     * Implementation note: implementations try to determine the size without reading the
+     * actual image first; if that is not possible the image is read, so it might be potentially
+     * expensive, but only for the first time (the image is stored in memory).
      *
      * \return the QSize of the image
      * \sa #readImage()
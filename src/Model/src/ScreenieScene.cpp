@@ -20,6 +20,7 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QList>
+#include <QtCore/QSet>
 #include <QtGui/QColor>
 
 #include "ScreenieModelInterface.h"
@@ -33,14 +34,30 @@ public:
         : backgroundEnabled(true),
           backgroundColor(QColor(255, 255, 255)),
           modified(false),
-          isTemplate(false)
+          isTemplate(false),
+          updateCount(0),
+          pendingChanges(NoChange)
     {}
 
+    /*!
+     * The kinds of change notifications, collected while an update transaction
+     * is in progress.
+     */
+    enum Change {
+        NoChange = 0x0,
+        SceneChange = 0x1,
+        DistanceChange = 0x2,
+        BackgroundChange = 0x4,
+        SelectionChange = 0x8
+    };
+
     bool backgroundEnabled;
     QColor backgroundColor;
     QList<ScreenieModelInterface *> screenieModels;
     bool modified;
     bool isTemplate;
+    int updateCount;
+    int pendingChanges;
 };
 
 // public
@@ -63,23 +80,21 @@ ScreenieScene::~ScreenieScene()
 void ScreenieScene::addModel(ScreenieModelInterface *screenieModel)
 {
     d->screenieModels.append(screenieModel);
-    // Note: by contract we send BOTH distanceChanged() and changed() signals,
-    //       when the 'screenieModel' changes distance
-    connect(screenieModel, SIGNAL(distanceChanged()),
-            this, SIGNAL(distanceChanged()));
-    connect(screenieModel, SIGNAL(distanceChanged()),
-            this, SIGNAL(changed()));
-    connect(screenieModel, SIGNAL(positionChanged()),
-            this, SIGNAL(changed()));
-    connect(screenieModel, SIGNAL(rotationChanged()),
-            this, SIGNAL(changed()));
-    connect(screenieModel, SIGNAL(reflectionChanged()),
-            this, SIGNAL(changed()));
-    connect(screenieModel, SIGNAL(changed()),
-            this, SIGNAL(changed()));
-    connect(screenieModel, SIGNAL(selectionChanged()),
-            this, SIGNAL(selectionChanged()));
+    connectModel(screenieModel);
     emit modelAdded(*screenieModel);
+    notify(ScreenieScenePrivate::SceneChange);
+}
+
+void ScreenieScene::addModels(const QList<ScreenieModelInterface *> &screenieModels)
+{
+    if (screenieModels.count() > 0) {
+        d->screenieModels.append(screenieModels);
+        foreach (ScreenieModelInterface *screenieModel, screenieModels) {
+            connectModel(screenieModel);
+        }
+        emit modelsAdded(screenieModels);
+        notify(ScreenieScenePrivate::SceneChange);
+    }
 }
 
 void ScreenieScene::removeModel(ScreenieModelInterface *screenieModel)
@@ -94,6 +109,41 @@ void ScreenieScene::removeModel(int index)
     d->screenieModels.removeAt(index);
     emit modelRemoved(*screenieModel);
     delete screenieModel;
+    notify(ScreenieScenePrivate::SceneChange);
+}
+
+void ScreenieScene::removeModels(const QList<ScreenieModelInterface *> &screenieModels)
+{
+    QSet<ScreenieModelInterface *> toBeRemoved = screenieModels.toSet();
+    QList<ScreenieModelInterface *> remainingModels;
+    QList<ScreenieModelInterface *> removedModels;
+    foreach (ScreenieModelInterface *screenieModel, d->screenieModels) {
+        if (toBeRemoved.contains(screenieModel)) {
+            removedModels.append(screenieModel);
+        } else {
+            remainingModels.append(screenieModel);
+        }
+    }
+    if (removedModels.count() > 0) {
+        d->screenieModels = remainingModels;
+        emit modelsRemoved(removedModels);
+        qDeleteAll(removedModels);
+        notify(ScreenieScenePrivate::SceneChange);
+    }
+}
+
+QList<ScreenieModelInterface *> ScreenieScene::takeModels()
+{
+    QList<ScreenieModelInterface *> result = d->screenieModels;
+    d->screenieModels.clear();
+    if (result.count() > 0) {
+        foreach (ScreenieModelInterface *screenieModel, result) {
+            disconnect(screenieModel, 0, this, 0);
+        }
+        emit modelsRemoved(result);
+        notify(ScreenieScenePrivate::SceneChange);
+    }
+    return result;
 }
 
 ScreenieModelInterface *ScreenieScene::getModel(int index) const
@@ -140,7 +190,7 @@ bool ScreenieScene::isBackgroundEnabled() const
 void ScreenieScene::setBackgroundEnabled(bool enable) {
     if (d->backgroundEnabled != enable) {
         d->backgroundEnabled = enable;
-        emit backgroundChanged();
+        notify(ScreenieScenePrivate::BackgroundChange | ScreenieScenePrivate::SceneChange);
     }
 }
 
@@ -151,7 +201,7 @@ QColor ScreenieScene::getBackgroundColor() const {
 void ScreenieScene::setBackgroundColor(QColor color) {
     if (d->backgroundColor != color) {
         d->backgroundColor = color;
-        emit backgroundChanged();
+        notify(ScreenieScenePrivate::BackgroundChange | ScreenieScenePrivate::SceneChange);
     }
 }
 
@@ -208,23 +258,116 @@ bool ScreenieScene::isDefault() const
     return result;
 }
 
+ScreenieScene *ScreenieScene::copy() const
+{
+    ScreenieScene *result = new ScreenieScene();
+    result->beginUpdate();
+    result->setTemplate(d->isTemplate);
+    result->setBackgroundEnabled(d->backgroundEnabled);
+    result->setBackgroundColor(d->backgroundColor);
+    QList<ScreenieModelInterface *> copies;
+    foreach (ScreenieModelInterface *screenieModel, d->screenieModels) {
+        copies.append(screenieModel->copy());
+    }
+    result->addModels(copies);
+    result->endUpdate();
+    result->setModified(d->modified);
+    return result;
+}
+
+void ScreenieScene::beginUpdate()
+{
+    ++d->updateCount;
+}
+
+void ScreenieScene::endUpdate()
+{
+    if (d->updateCount > 0) {
+        --d->updateCount;
+        if (d->updateCount == 0 && d->pendingChanges != ScreenieScenePrivate::NoChange) {
+            int changes = d->pendingChanges;
+            d->pendingChanges = ScreenieScenePrivate::NoChange;
+            notify(changes);
+        }
+    }
+#ifdef DEBUG
+    else {
+        qCritical("ScreenieScene::endUpdate: called without matching beginUpdate()");
+    }
+#endif
+}
+
+bool ScreenieScene::isUpdating() const
+{
+    return d->updateCount > 0;
+}
+
 // private
 
 void ScreenieScene::frenchConnection()
 {
-    connect(this, SIGNAL(backgroundChanged()),
-            this, SIGNAL(changed()));
-    connect(this, SIGNAL(modelAdded(ScreenieModelInterface&)),
-            this, SIGNAL(changed()));
-    connect(this, SIGNAL(modelRemoved(ScreenieModelInterface&)),
-            this, SIGNAL(changed()));
     connect(this, SIGNAL(changed()),
             this, SLOT(handleChanged()));
 }
 
+void ScreenieScene::connectModel(ScreenieModelInterface *screenieModel)
+{
+    // Note: by contract we send BOTH distanceChanged() and changed() signals,
+    //       when the 'screenieModel' changes distance
+    connect(screenieModel, SIGNAL(distanceChanged()),
+            this, SLOT(handleDistanceChanged()));
+    connect(screenieModel, SIGNAL(positionChanged()),
+            this, SLOT(handleModelChanged()));
+    connect(screenieModel, SIGNAL(rotationChanged()),
+            this, SLOT(handleModelChanged()));
+    connect(screenieModel, SIGNAL(reflectionChanged()),
+            this, SLOT(handleModelChanged()));
+    connect(screenieModel, SIGNAL(changed()),
+            this, SLOT(handleModelChanged()));
+    connect(screenieModel, SIGNAL(selectionChanged()),
+            this, SLOT(handleSelectionChanged()));
+}
+
+void ScreenieScene::notify(int changes)
+{
+    if (d->updateCount > 0) {
+        d->pendingChanges |= changes;
+    } else {
+        // the specialised signals come first, changed() last: receivers of
+        // changed() are to see a consistent scene
+        if (changes & ScreenieScenePrivate::BackgroundChange) {
+            emit backgroundChanged();
+        }
+        if (changes & ScreenieScenePrivate::DistanceChange) {
+            emit distanceChanged();
+        }
+        if (changes & ScreenieScenePrivate::SelectionChange) {
+            emit selectionChanged();
+        }
+        if (changes & ScreenieScenePrivate::SceneChange) {
+            emit changed();
+        }
+    }
+}
+
 // private slots
 
 void ScreenieScene::handleChanged()
 {
     setModified(true);
 }
+
+void ScreenieScene::handleModelChanged()
+{
+    notify(ScreenieScenePrivate::SceneChange);
+}
+
+void ScreenieScene::handleDistanceChanged()
+{
+    notify(ScreenieScenePrivate::DistanceChange | ScreenieScenePrivate::SceneChange);
+}
+
+void ScreenieScene::handleSelectionChanged()
+{
+    notify(ScreenieScenePrivate::SelectionChange);
+}
@@ -51,6 +51,20 @@ public:
      */
     MODEL_API void addModel(ScreenieModelInterface *screenieModel);
 
+    /*!
+     * Adds all \p screenieModels to this ScreenieScene, in the given order. This ScreenieScene
+     * takes ownership and the \p screenieModels must have been allocated on the heap.
+     *
+     * Only the single #modelsAdded(const QList<ScreenieModelInterface *> &) signal is emitted,
+     * instead of a #modelAdded(ScreenieModelInterface &) signal for each model.
+     *
+     * \param screenieModels
+     *        the ScreenieModels to be added
+     * \sa #modelsAdded(const QList<ScreenieModelInterface *> &)
+     * \sa #changed()
+     */
+    MODEL_API void addModels(const QList<ScreenieModelInterface *> &screenieModels);
+
     /*!
      * \sa #modelRemoved(const ScreenieModelInterface &)
      * \sa #changed()
@@ -63,6 +77,28 @@ public:
      */
     MODEL_API void removeModel(int index);
 
+    /*!
+     * Removes and deletes all \p screenieModels in a single pass. Models which are not
+     * part of this ScreenieScene are ignored.
+     *
+     * Only the single #modelsRemoved(const QList<ScreenieModelInterface *> &) signal is emitted,
+     * instead of a #modelRemoved(ScreenieModelInterface &) signal for each model.
+     *
+     * \sa #modelsRemoved(const QList<ScreenieModelInterface *> &)
+     * \sa #changed()
+     */
+    MODEL_API void removeModels(const QList<ScreenieModelInterface *> &screenieModels);
+
+    /*!
+     * Removes all models from this ScreenieScene \em without deleting them:
+     * ownership is transferred to the caller.
+     *
+     * \return the removed models; must be \c deleted by the caller (or added to another ScreenieScene)
+     * \sa #modelsRemoved(const QList<ScreenieModelInterface *> &)
+     * \sa #changed()
+     */
+    MODEL_API QList<ScreenieModelInterface *> takeModels();
+
     /*!
      * \return the ScreenieModelInterface identified by \p index; may be 0
      * \sa #count()
@@ -151,6 +187,48 @@ public:
      */
     MODEL_API bool isDefault() const;
 
+    /*!
+     * Creates a copy of this ScreenieScene, including copies of all its models. The
+     * copy is cheap: the images of the models are implicitly shared.
+     *
+     * \return the copy; must be \c deleted by the caller
+     * \sa ScreenieModelInterface#copy()
+     */
+    MODEL_API ScreenieScene *copy() const;
+
+    /*!
+     * Starts an update transaction: until the matching #endUpdate() the change notifications
+     * of this ScreenieScene and its models are collected rather than emitted. Each kind
+     * of notification - #changed(), #distanceChanged(), #backgroundChanged() and
+     * #selectionChanged() - is then emitted at most once when the transaction is committed.
+     *
+     * The #modelAdded(ScreenieModelInterface &) and #modelRemoved(ScreenieModelInterface &)
+     * signals are still emitted immediately, as the model references are only valid
+     * at that time.
+     *
+     * Transactions may be nested: the notifications are emitted when the outermost
+     * transaction ends.
+     *
+     * \sa #endUpdate()
+     * \sa #isUpdating()
+     */
+    MODEL_API void beginUpdate();
+
+    /*!
+     * Ends the update transaction started with #beginUpdate() and emits the collected
+     * change notifications, if this was the outermost transaction.
+     *
+     * \sa #beginUpdate()
+     */
+    MODEL_API void endUpdate();
+
+    /*!
+     * \return \c true if an update transaction is in progress; \c false else
+     *
+     * \sa #beginUpdate()
+     */
+    MODEL_API bool isUpdating() const;
+
 signals:
     /*!
      * Emitted whenever this ScreenieScene or one of the instances of the ScreenieModelInterface has changed.
@@ -166,9 +244,15 @@ signals:
      * \sa #modelRemoved(ScreenieModelInterface &)
      * \sa #backgroundChanged()
      * \sa #distanceChanged
+     * \sa #beginUpdate()
      */
     void changed();
 
+    /*!
+     * Emitted whenever the \p screenieModel has been added to the scene.
+     *
+     * This signal is emitted <em>in addition</em> to the #changed() signal.
+     */
     void modelAdded(ScreenieModelInterface &screenieModel);
 
     /*!
@@ -181,6 +265,20 @@ signals:
      * \p screenieModel, for example.
      */
     void modelRemoved(ScreenieModelInterface &screenieModel);
+
+    /*!
+     * Emitted once when the \p screenieModels have been added with #addModels(const QList<ScreenieModelInterface *> &).
+     * No #modelAdded(ScreenieModelInterface &) signals are emitted for these models.
+     */
+    void modelsAdded(const QList<ScreenieModelInterface *> &screenieModels);
+
+    /*!
+     * Emitted once when the \p screenieModels have been removed with #removeModels(const QList<ScreenieModelInterface *> &)
+     * or #takeModels(). No #modelRemoved(ScreenieModelInterface &) signals are emitted for these models.
+     * As with #modelRemoved(ScreenieModelInterface &) the models may be \c deleted right after the signal
+     * has been emitted.
+     */
+    void modelsRemoved(const QList<ScreenieModelInterface *> &screenieModels);
     void backgroundChanged();
     void distanceChanged();
     void selectionChanged();
@@ -190,9 +288,14 @@ private:
     ScreenieScenePrivate *d;
 
     void frenchConnection();
+    void connectModel(ScreenieModelInterface *screenieModel);
+    void notify(int changes);
 
 private slots:
     void handleChanged();
+    void handleModelChanged();
+    void handleDistanceChanged();
+    void handleSelectionChanged();
 };
 
 #endif // SCREENIESCENE_H
@@ -91,6 +91,12 @@ const QImage &ScreenieTemplateModel::readImage() const
     return d->image;
 }
 
+const QImage &ScreenieTemplateModel::requestImage() const
+{
+    // creating the template image is cheap
+    return readImage();
+}
+
 QSize ScreenieTemplateModel::getSize() const
 {
     return d->sizeFitter.getTargetSize();
@@ -62,6 +62,7 @@ public:
     virtual ~ScreenieTemplateModel();
 
     virtual const QImage &readImage() const;
+    virtual const QImage &requestImage() const;
 
     /*!
      * Returns the requested size.
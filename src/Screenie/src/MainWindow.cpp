@@ -24,6 +24,7 @@
 #include <QtCore/QDir>
 #include <QtCore/QFileInfo>
 #include <QtCore/QList>
+#include <QtCore/QStringList>
 #include <QtCore/QSignalMapper>
 #include <QtCore/QEvent>
 #include <QtGui/QApplication>
@@ -57,12 +58,14 @@
 #include "../../Model/src/ScreenieModelInterface.h"
 #include "../../Model/src/ScreenieTemplateModel.h"
 #include "../../Model/src/Dao/ScreenieSceneDao.h"
-#include "../../Model/src/Dao/Xml/XmlScreenieSceneDao.h"
+#include "../../Model/src/Dao/ScreenieSceneDaoFactory.h"
 #include "../../Kernel/src/ExportImage.h"
 #include "../../Kernel/src/Clipboard/Clipboard.h"
 #include "../../Kernel/src/ScreenieControl.h"
 #include "../../Kernel/src/ScreenieGraphicsScene.h"
 #include "../../Kernel/src/ScreeniePixmapItem.h"
+#include "../../Kernel/src/ScreenieSceneWriter.h"
+#include "../../Kernel/src/AutoSaveJournal.h"
 #include "../../Kernel/src/PropertyDialogFactory.h"
 #include "../../Kernel/src/DocumentManager.h"
 #include "../../Kernel/src/DocumentInfo.h"
@@ -83,6 +86,7 @@ MainWindow::MainWindow(QWidget *parent) :
     ui->setupUi(this);
 
     m_screenieGraphicsScene = new ScreenieGraphicsScene(this);
+    m_screenieSceneWriter = new ScreenieSceneWriter(this);
     ui->graphicsView->setScene(m_screenieGraphicsScene);
     ui->graphicsView->setAcceptDrops(true);
 
@@ -107,6 +111,8 @@ MainWindow::MainWindow(QWidget *parent) :
 
 MainWindow::~MainWindow()
 {
+    // the journal is removed, since the document is closed regularly
+    delete m_autoSaveJournal;
     delete m_screenieScene;
     delete m_screenieControl;
     delete m_platformManager;
@@ -117,8 +123,9 @@ bool MainWindow::read(const QString &filePath)
 {
     bool result;
     QFile file(filePath);
-    ScreenieSceneDao *screenieSceneDao = new XmlScreenieSceneDao(file);
+    ScreenieSceneDao *screenieSceneDao = ScreenieSceneDaoFactory::createReader(file);
     ScreenieScene *screenieScene = screenieSceneDao->read();
+    delete screenieSceneDao;
     if (screenieScene != 0) {
         m_documentFilePath = filePath;
         newScene(*screenieScene);
@@ -129,6 +136,22 @@ bool MainWindow::read(const QString &filePath)
     return result;
 }
 
+bool MainWindow::recover(const QString &journalPath)
+{
+    bool result;
+    ScreenieScene *screenieScene = AutoSaveJournal::recover(journalPath);
+    if (screenieScene != 0) {
+        newScene(*screenieScene);
+        setWindowModified(true);
+        // the new scene is journaled from now on
+        AutoSaveJournal::remove(journalPath);
+        result = true;
+    } else {
+        result = false;
+    }
+    return result;
+}
+
 // public slots
 
 void MainWindow::showFullScreen()
@@ -157,6 +180,8 @@ void MainWindow::showNormal()
 
 void MainWindow::closeEvent(QCloseEvent *event)
 {
+    // a save in progress decides whether the scene is still modified
+    m_screenieSceneWriter->waitForFinished();
     if (m_screenieScene->isModified()) {
         DocumentInfo::SaveStrategy saveStrategy = DocumentManager::getInstance().getSaveStrategy(*this);
         switch (saveStrategy) {
@@ -198,6 +223,8 @@ void MainWindow::frenchConnection()
             this, SLOT(updateUi()));
     connect(&DocumentManager::getInstance(), SIGNAL(changed()),
             this, SLOT(updateWindowMenu()));
+    connect(m_screenieSceneWriter, SIGNAL(finished(bool, const QString &, ScreenieScene *)),
+            this, SLOT(handleSceneWritten(bool, const QString &, ScreenieScene *)));
 
     // recent files
     connect(&m_recentFiles, SIGNAL(openRecentFile(const QString &)),
@@ -216,25 +243,27 @@ void MainWindow::newScene(ScreenieScene &screenieScene)
     updateTitle();
 }
 
-bool MainWindow::writeScene(const QString &filePath)
+void MainWindow::writeScene(const QString &filePath)
 {
-    bool result;
-    QFile file(filePath);
-    ScreenieSceneDao *screenieSceneDao = new XmlScreenieSceneDao(file);
-    result = screenieSceneDao->write(*m_screenieScene);
-    if (result) {
-        m_screenieScene->setModified(false);
-        setWindowModified(false);
-        m_documentFilePath = filePath;
-        updateTitle();
-    }
-    return result;
+    // the preview is rendered here, as the graphics scene is only accessible in the main thread
+    ExportImage exportImage(*m_screenieScene, *m_screenieGraphicsScene);
+    m_screenieSceneWriter->write(*m_screenieScene, filePath, exportImage.exportPreview());
 }
 
-bool MainWindow::writeTemplate(const QString &filePath)
+void MainWindow::writeTemplate(const QString &filePath)
 {
     m_screenieControl->convertItemsToTemplate(*m_screenieScene);
-    return writeScene(filePath);
+    writeScene(filePath);
+}
+
+bool MainWindow::writeSceneAndWait(const QString &filePath)
+{
+    bool result;
+    writeScene(filePath);
+    m_screenieSceneWriter->waitForFinished();
+    // the scene cannot have been changed while waiting
+    result = !m_screenieScene->isModified();
+    return result;
 }
 
 void MainWindow::initializeUi()
@@ -376,11 +405,13 @@ void MainWindow::createScene()
     m_screenieScene = new ScreenieScene();
     m_screenieControl = new ScreenieControl(*m_screenieScene, *m_screenieGraphicsScene);
     m_clipboard = new Clipboard(*m_screenieControl, this);
+    m_autoSaveJournal = new AutoSaveJournal(*m_screenieScene);
 }
 
 void MainWindow::updateScene(ScreenieScene &screenieScene)
 {
     // delete previous instances
+    delete m_autoSaveJournal;
     delete m_screenieScene;
     delete m_screenieControl;
     delete m_clipboard;
@@ -388,6 +419,7 @@ void MainWindow::updateScene(ScreenieScene &screenieScene)
 
     m_screenieControl = new ScreenieControl(*m_screenieScene, *m_screenieGraphicsScene);
     m_clipboard = new Clipboard(*m_screenieControl, this);
+    m_autoSaveJournal = new AutoSaveJournal(*m_screenieScene);
     m_screenieControl->updateScene();
     updateUi();
     updateDocumentManager();
@@ -440,12 +472,10 @@ void MainWindow::askBeforeClose()
 void MainWindow::saveBeforeClose()
 {
     if (!isFilePathRequired()) {
-        bool ok = writeScene(m_documentFilePath);
+        // errors are reported by handleSceneWritten()
+        bool ok = writeSceneAndWait(m_documentFilePath);
         if (ok) {
             close();
-        } else {
-            showWriteError(DocumentManager::getInstance().getDocumentName(*this),
-                           QDir::toNativeSeparators(m_documentFilePath));
         }
 #ifdef DEBUG
         qDebug("MainWindow::saveBeforeClose: ok: %d", ok);
@@ -460,10 +490,14 @@ void MainWindow::saveAsBeforeClose()
     QString lastDocumentDirectoryPath = Settings::getInstance().getLastDocumentDirectoryPath();
     QString sceneFilter = tr("Screenie Scene (*.%1)", "Save As dialog filter")
                           .arg(FileUtils::SceneExtension);
+    QString packageFilter = tr("Screenie Package (*.%1)", "Save As dialog filter")
+                            .arg(FileUtils::PackageExtension);
 
     QFileDialog *fileDialog = new QFileDialog(this, Qt::Sheet);
-    fileDialog->setNameFilter(sceneFilter);
+    fileDialog->setNameFilters(QStringList() << sceneFilter << packageFilter);
     fileDialog->setDefaultSuffix(FileUtils::SceneExtension);
+    connect(fileDialog, SIGNAL(filterSelected(const QString &)),
+            this, SLOT(handleSaveAsFilterSelected(const QString &)));
     fileDialog->setWindowTitle(tr("Save As"));
     fileDialog->setDirectory(lastDocumentDirectoryPath);
     fileDialog->setWindowModality(Qt::WindowModal);
@@ -557,14 +591,17 @@ void MainWindow::on_openAction_triggered()
 {
     Settings &settings = Settings::getInstance();
     QString lastDocumentDirectoryPath = settings.getLastDocumentDirectoryPath();
-    QString allFilter = tr("Screenie Scenes (*.%1 *.%2)", "Open dialog filter")
+    QString allFilter = tr("Screenie Scenes (*.%1 *.%2 *.%3)", "Open dialog filter")
                         .arg(FileUtils::SceneExtension)
+                        .arg(FileUtils::PackageExtension)
                         .arg(FileUtils::TemplateExtension);
     QString sceneFilter = tr("Screenie Scene (*.%1)", "Open dialog filter")
                           .arg(FileUtils::SceneExtension);
+    QString packageFilter = tr("Screenie Package (*.%1)", "Open dialog filter")
+                            .arg(FileUtils::PackageExtension);
     QString templateFilter = tr("Screenie Template (*.%1)", "Open dialog filter")
                              .arg(FileUtils::TemplateExtension);
-    QString filter = allFilter + ";;" + sceneFilter + ";;" + templateFilter;
+    QString filter = allFilter + ";;" + sceneFilter + ";;" + packageFilter + ";;" + templateFilter;
 
     QString filePath = QFileDialog::getOpenFileName(this, tr("Open", "Open file dialog"), lastDocumentDirectoryPath, filter);
 
@@ -594,15 +631,7 @@ void MainWindow::on_saveAction_triggered()
 {
     // save with given 'm_documentFilePath', if scene is not a template or if so, has only template items
     if (!isFilePathRequired()) {
-        bool ok = writeScene(m_documentFilePath);
-#ifdef DEBUG
-        qDebug("MainWindow::on_saveAction_triggered: ok: %d", ok);
-#endif
-        if (!ok) {
-            showWriteError(DocumentManager::getInstance().getDocumentName(*this),
-                           QDir::toNativeSeparators(m_documentFilePath));
-
-        }
+        writeScene(m_documentFilePath);
     } else {
         on_saveAsAction_triggered();
     }
@@ -613,10 +642,14 @@ void MainWindow::on_saveAsAction_triggered()
     QString lastDocumentDirectoryPath = Settings::getInstance().getLastDocumentDirectoryPath();
     QString sceneFilter = tr("Screenie Scene (*.%1)", "Save As dialog filter")
                              .arg(FileUtils::SceneExtension);
+    QString packageFilter = tr("Screenie Package (*.%1)", "Save As dialog filter")
+                               .arg(FileUtils::PackageExtension);
 
     QFileDialog *fileDialog = new QFileDialog(this, Qt::Sheet);
-    fileDialog->setNameFilter(sceneFilter);
+    fileDialog->setNameFilters(QStringList() << sceneFilter << packageFilter);
     fileDialog->setDefaultSuffix(FileUtils::SceneExtension);
+    connect(fileDialog, SIGNAL(filterSelected(const QString &)),
+            this, SLOT(handleSaveAsFilterSelected(const QString &)));
     fileDialog->setWindowTitle(tr("Save As"));
     fileDialog->setDirectory(lastDocumentDirectoryPath);
     fileDialog->setWindowModality(Qt::WindowModal);
@@ -728,6 +761,21 @@ void MainWindow::on_addTemplateAction_triggered()
     m_screenieControl->addTemplate(QPointF(0.0, 0.0));
 }
 
+void MainWindow::on_zoomInAction_triggered()
+{
+    m_screenieControl->zoomIn();
+}
+
+void MainWindow::on_zoomOutAction_triggered()
+{
+    m_screenieControl->zoomOut();
+}
+
+void MainWindow::on_actualSizeAction_triggered()
+{
+    m_screenieControl->resetZoom();
+}
+
 void MainWindow::on_toggleFullScreenAction_triggered()
 {
     if (!isFullScreen()) {
@@ -924,37 +972,17 @@ void MainWindow::updateWindowMenu()
 
 void MainWindow::handleFileSaveAsSelected(const QString &filePath)
 {
-    bool ok = false;
     if (!filePath.isNull()) {
         m_screenieScene->setTemplate(false);
-        ok = writeScene(filePath);
-        if (ok) {
-            QString lastDocumentDirectoryPath = QFileInfo(filePath).absolutePath();
-            Settings &settings = Settings::getInstance();
-            settings.setLastDocumentDirectoryPath(lastDocumentDirectoryPath);
-            settings.addRecentFile(filePath);
-        } else {
-            showWriteError(DocumentManager::getInstance().getDocumentName(*this),
-                           QDir::toNativeSeparators(filePath));
-        }
+        writeScene(filePath);
     }
 }
 
 void MainWindow::handleFileSaveAsTemplateSelected(const QString &filePath)
 {
-    bool ok = false;
     if (!filePath.isNull()) {
         m_screenieScene->setTemplate(true);
-        ok = writeTemplate(filePath);
-        if (ok) {
-            QString lastDocumentDirectoryPath = QFileInfo(filePath).absolutePath();
-            Settings &settings = Settings::getInstance();
-            settings.setLastDocumentDirectoryPath(lastDocumentDirectoryPath);
-            settings.addRecentFile(filePath);
-        } else {
-            showWriteError(DocumentManager::getInstance().getDocumentName(*this),
-                           filePath);
-        }
+        writeTemplate(filePath);
     }
 }
 
@@ -963,20 +991,28 @@ void MainWindow::handleFileSaveAsBeforeCloseSelected(const QString &filePath)
     bool ok = false;
     if (!filePath.isNull()) {
         m_screenieScene->setTemplate(false);
-        ok = writeScene(filePath);
+        // errors are reported by handleSceneWritten()
+        ok = writeSceneAndWait(filePath);
         if (ok) {
-            QString lastDocumentDirectoryPath = QFileInfo(filePath).absolutePath();
-            Settings &settings = Settings::getInstance();
-            settings.setLastDocumentDirectoryPath(lastDocumentDirectoryPath);
-            settings.addRecentFile(filePath);
             if (DocumentManager::getCloseRequest() == DocumentManager::CloseCurrent) {
                 close();
             } else {
                 QApplication::closeAllWindows();
             }
+        }
+    }
+}
+
+void MainWindow::handleSaveAsFilterSelected(const QString &filter)
+{
+    QFileDialog *fileDialog = qobject_cast<QFileDialog *>(sender());
+    if (fileDialog != 0) {
+        // the scene DAO is chosen by the extension: a file name typed without
+        // extension must get the extension of the selected format
+        if (filter.contains("*." + FileUtils::PackageExtension)) {
+            fileDialog->setDefaultSuffix(FileUtils::PackageExtension);
         } else {
-            showWriteError(DocumentManager::getInstance().getDocumentName(*this),
-                           QDir::toNativeSeparators(filePath));
+            fileDialog->setDefaultSuffix(FileUtils::SceneExtension);
         }
     }
 }
@@ -1005,3 +1041,33 @@ void MainWindow::handleAskBeforeClose(int answer)
     }
 }
 
+void MainWindow::handleSceneWritten(bool ok, const QString &filePath, ScreenieScene *screenieScene)
+{
+#ifdef DEBUG
+    qDebug("MainWindow::handleSceneWritten: ok: %d", ok);
+#endif
+    if (ok && screenieScene != m_screenieScene) {
+        // the document has been replaced while its scene was being written: the
+        // file path and the journal of the current document remain as they are
+        QString lastDocumentDirectoryPath = QFileInfo(filePath).absolutePath();
+        Settings &settings = Settings::getInstance();
+        settings.setLastDocumentDirectoryPath(lastDocumentDirectoryPath);
+        settings.addRecentFile(filePath);
+    } else if (ok) {
+        // the scene might have been modified again while it was being written
+        setWindowModified(m_screenieScene->isModified());
+        if (!m_screenieScene->isModified()) {
+            m_autoSaveJournal->discard();
+        }
+        m_documentFilePath = filePath;
+        updateTitle();
+        QString lastDocumentDirectoryPath = QFileInfo(filePath).absolutePath();
+        Settings &settings = Settings::getInstance();
+        settings.setLastDocumentDirectoryPath(lastDocumentDirectoryPath);
+        settings.addRecentFile(filePath);
+    } else {
+        showWriteError(DocumentManager::getInstance().getDocumentName(*this),
+                       QDir::toNativeSeparators(filePath));
+    }
+}
+
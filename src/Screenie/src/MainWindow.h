@@ -39,6 +39,8 @@ class ScreeniePixmapItem;
 class ScreenieControl;
 class ScreenieGraphicsScene;
 class Clipboard;
+class ScreenieSceneWriter;
+class AutoSaveJournal;
 class PlatformManager;
 
 namespace Ui {
@@ -54,6 +56,14 @@ public:
 
     bool read(const QString &filePath);
 
+    /*!
+     * Recovers the scene from the autosave journal at \p journalPath, which is
+     * removed afterwards. The recovered scene is marked as modified.
+     *
+     * \sa AutoSaveJournal
+     */
+    bool recover(const QString &journalPath);
+
 public slots:
     virtual void showFullScreen();
     virtual void showNormal();
@@ -69,6 +79,8 @@ private:
     ScreenieGraphicsScene *m_screenieGraphicsScene;
     ScreenieScene *m_screenieScene;
     ScreenieControl *m_screenieControl;
+    ScreenieSceneWriter *m_screenieSceneWriter;
+    AutoSaveJournal *m_autoSaveJournal;
     bool m_ignoreUpdateSignals;
     Clipboard *m_clipboard;
     QString m_documentFilePath;
@@ -79,8 +91,11 @@ private:
     void frenchConnection();
 
     void newScene(ScreenieScene &screenieScene);
-    bool writeScene(const QString &filePath);
-    bool writeTemplate(const QString &filePath);
+    // starts writing in the background, the result is handled in handleSceneWritten()
+    void writeScene(const QString &filePath);
+    void writeTemplate(const QString &filePath);
+    // writes and waits for the result
+    bool writeSceneAndWait(const QString &filePath);
 
     void initializeUi();
     void updateTransformationUi();
@@ -130,6 +145,9 @@ private slots:
     void on_addTemplateAction_triggered();
 
     // View
+    void on_zoomInAction_triggered();
+    void on_zoomOutAction_triggered();
+    void on_actualSizeAction_triggered();
     void on_toggleFullScreenAction_triggered();
 
     // About
@@ -159,8 +177,10 @@ private slots:
     void handleFileSaveAsSelected(const QString &filePath);
     void handleFileSaveAsTemplateSelected(const QString &filePath);
     void handleFileSaveAsBeforeCloseSelected(const QString &filePath);
+    void handleSaveAsFilterSelected(const QString &filter);
 
     void handleAskBeforeClose(int answer);
+    void handleSceneWritten(bool ok, const QString &filePath, ScreenieScene *screenieScene);
 };
 
 #endif // MAINWINDOW_H
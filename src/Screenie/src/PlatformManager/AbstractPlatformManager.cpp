@@ -48,6 +48,10 @@ void AbstractPlatformManager::initialize(QMainWindow &mainWindow, Ui::MainWindow
     // Insert
     mainWindowUi.addImageAction->setShortcut(QKeySequence(Qt::Key_I + Qt::CTRL));
     mainWindowUi.addTemplateAction->setShortcut(QKeySequence(Qt::Key_T + Qt::CTRL));
+    // View
+    mainWindowUi.zoomInAction->setShortcut(QKeySequence::ZoomIn);
+    mainWindowUi.zoomOutAction->setShortcut(QKeySequence::ZoomOut);
+    mainWindowUi.actualSizeAction->setShortcut(QKeySequence(Qt::Key_0 + Qt::CTRL));
     // Generic
     QShortcut *shortcut = new QShortcut(QKeySequence("Backspace"), &mainWindow);
     QObject::connect(shortcut, SIGNAL(activated()),
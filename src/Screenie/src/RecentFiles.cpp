@@ -20,12 +20,19 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QFileInfo>
+#include <QtCore/QFile>
+#include <QtCore/QSet>
 #include <QtCore/QVariant>
 #include <QtGui/QAction>
 #include <QtGui/QActionGroup>
 #include <QtGui/QKeySequence>
+#include <QtGui/QIcon>
+#include <QtGui/QImage>
+#include <QtGui/QPixmap>
 
 #include "../../Utils/src/Settings.h"
+#include "../../Model/src/Dao/ScreenieSceneDao.h"
+#include "../../Model/src/Dao/ScreenieSceneDaoFactory.h"
 #include "RecentFiles.h"
 
 namespace
@@ -78,6 +85,30 @@ void RecentFiles::initialise()
     m_recentFilesActionGroup->addAction(m_clearRecentFilesAction);
 }
 
+QIcon RecentFiles::getPreviewIcon(const QFileInfo &fileInfo)
+{
+    QIcon result;
+    QString filePath = fileInfo.absoluteFilePath();
+    QDateTime lastModified = fileInfo.lastModified();
+    if (m_previewIcons.contains(filePath) && m_previewIcons.value(filePath).lastModified == lastModified) {
+        result = m_previewIcons.value(filePath).icon;
+    } else {
+        // only the first few kilobytes of the file are read
+        QFile file(filePath);
+        ScreenieSceneDao *screenieSceneDao = ScreenieSceneDaoFactory::createReader(file);
+        QImage preview = screenieSceneDao->readPreview();
+        delete screenieSceneDao;
+        if (!preview.isNull()) {
+            result = QIcon(QPixmap::fromImage(preview));
+        }
+        PreviewIcon previewIcon;
+        previewIcon.lastModified = lastModified;
+        previewIcon.icon = result;
+        m_previewIcons.insert(filePath, previewIcon);
+    }
+    return result;
+}
+
 void RecentFiles::frenchConnection()
 {
     Settings &settings = Settings::getInstance();
@@ -119,6 +150,7 @@ void RecentFiles::updateRecentFilesActions()
         }
         const QString text = fileInfo.fileName();
         recentFilesActions[i]->setText(text);
+        recentFilesActions[i]->setIcon(getPreviewIcon(fileInfo));
         recentFilesActions[i]->setData(recentFiles[i]);
         recentFilesActions[i]->setVisible(true);
         recentFilesActions[i]->setShortcut(QKeySequence(ActionKeys[i] | Qt::CTRL));
@@ -129,6 +161,17 @@ void RecentFiles::updateRecentFilesActions()
         recentFilesActions[i]->setVisible(false);
     }
 
+    // forget the previews of files which are not listed anymore
+    QSet<QString> listedFilePaths;
+    for (i = 0; i < nofRecentFiles; ++i) {
+        listedFilePaths.insert(QFileInfo(recentFiles[i]).absoluteFilePath());
+    }
+    foreach (const QString &filePath, m_previewIcons.keys()) {
+        if (!listedFilePaths.contains(filePath)) {
+            m_previewIcons.remove(filePath);
+        }
+    }
+
     // If there's been a change, write it back
     if (originalSize != recentFiles.count()) {
         m_ignoreUpdateSignals = true;
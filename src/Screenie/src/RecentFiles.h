@@ -22,14 +22,20 @@
 #define RECENTFILES_H
 
 #include <QtCore/QObject>
+#include <QtCore/QHash>
+#include <QtCore/QDateTime>
+#include <QtCore/QString>
+#include <QtGui/QIcon>
 
 class QActionGroup;
 class QAction;
+class QFileInfo;
 
 /*!
  * \brief The recently opened files.
  *
  * Provides a menu with QActions which give access to the recently opened files.
+ * The actions show the preview stored in the files as icon.
  */
 class RecentFiles : public QObject
 {
@@ -51,7 +57,15 @@ private:
     bool m_ignoreUpdateSignals;
     QAction *m_clearRecentFilesAction;
 
+    struct PreviewIcon {
+        QDateTime lastModified;
+        QIcon icon;
+    };
+    // the previews are only read again when a file has been modified
+    QHash<QString, PreviewIcon> m_previewIcons;
+
     void initialise();
+    QIcon getPreviewIcon(const QFileInfo &fileInfo);
     void frenchConnection();
 
 private slots:
@@ -26,8 +26,11 @@
 #include <QtGui/QIcon>
 #include <QtCore/QEvent>
 #include <QtGui/QFileOpenEvent>
+#include <QtGui/QMessageBox>
 
 #include "../../Utils/src/Settings.h"
+#include "../../Utils/src/Version.h"
+#include "../../Kernel/src/AutoSaveJournal.h"
 #include "../../Kernel/src/DocumentManager.h"
 #include "PlatformManager/PlatformManagerFactory.h"
 #include "MainWindow.h"
@@ -56,6 +59,7 @@ void ScreenieApplication::show()
         m_mainWindow->read(args.at(1));
     }
     m_mainWindow->show();
+    recoverDocuments();
 }
 
 // protected
@@ -77,6 +81,32 @@ bool ScreenieApplication::event(QEvent *event)
 
 // private
 
+void ScreenieApplication::recoverDocuments()
+{
+    QStringList journalPaths = AutoSaveJournal::getRecoverableJournals();
+    if (journalPaths.count() > 0) {
+        QMessageBox::StandardButton answer = QMessageBox::question(m_mainWindow, Version::getApplicationName(),
+                                                                   tr("%1 was not quit properly. Do you want to recover %2 unsaved document(s)?")
+                                                                   .arg(Version::getApplicationName())
+                                                                   .arg(journalPaths.count()),
+                                                                   QMessageBox::Yes | QMessageBox::No, QMessageBox::Yes);
+        foreach (const QString &journalPath, journalPaths) {
+            if (answer == QMessageBox::Yes) {
+                MainWindow *mainWindow = new MainWindow();
+                mainWindow->setAttribute(Qt::WA_DeleteOnClose, true);
+                if (mainWindow->recover(journalPath)) {
+                    mainWindow->show();
+                } else {
+                    delete mainWindow;
+                    AutoSaveJournal::remove(journalPath);
+                }
+            } else {
+                AutoSaveJournal::remove(journalPath);
+            }
+        }
+    }
+}
+
 void ScreenieApplication::frenchConnection()
 {
     connect(QApplication::instance(), SIGNAL(lastWindowClosed()),
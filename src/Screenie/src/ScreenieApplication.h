@@ -61,6 +61,8 @@ protected:
 private:
     MainWindow *m_mainWindow;
 
+    // offers to recover the documents of crashed application instances
+    void recoverDocuments();
     void frenchConnection();
 
 private slots:
@@ -6,10 +6,16 @@ HEADERS += $$PWD/src/UtilsLib.h \
            $$PWD/src/Settings.h \
            $$PWD/src/Version.h \
            $$PWD/src/SizeFitter.h \
-           $$PWD/src/FileUtils.h
+           $$PWD/src/FileUtils.h \
+           $$PWD/src/ThumbnailCache.h \
+           $$PWD/src/Base64Decoder.h \
+           $$PWD/src/CompressedDevice.h
 
 SOURCES += $$PWD/src/PaintTools.cpp \
            $$PWD/src/Settings.cpp \
            $$PWD/src/Version.cpp \
            $$PWD/src/SizeFitter.cpp \
-           $$PWD/src/FileUtils.cpp
+           $$PWD/src/FileUtils.cpp \
+           $$PWD/src/ThumbnailCache.cpp \
+           $$PWD/src/Base64Decoder.cpp \
+           $$PWD/src/CompressedDevice.cpp
@@ -0,0 +1,122 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QtCore/QByteArray>
+#include <QtCore/QChar>
+
+#include "Base64Decoder.h"
+
+namespace
+{
+    // maps Latin-1 characters to their 6 bit values; -1 marks characters which are skipped
+    const signed char DecodeTable[256] = {
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, 62, -1, -1, -1, 63,
+        52, 53, 54, 55, 56, 57, 58, 59, 60, 61, -1, -1, -1, -1, -1, -1,
+        -1,  0,  1,  2,  3,  4,  5,  6,  7,  8,  9, 10, 11, 12, 13, 14,
+        15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, -1, -1, -1, -1, -1,
+        -1, 26, 27, 28, 29, 30, 31, 32, 33, 34, 35, 36, 37, 38, 39, 40,
+        41, 42, 43, 44, 45, 46, 47, 48, 49, 50, 51, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1,
+        -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1, -1
+    };
+
+    inline int decodeCharacter(ushort character)
+    {
+        return character < 256 ? DecodeTable[character] : -1;
+    }
+}
+
+class Base64DecoderPrivate
+{
+public:
+    Base64DecoderPrivate(QByteArray &theOutput)
+        : output(theOutput),
+          buffer(0),
+          bits(0)
+    {}
+
+    QByteArray &output;
+    // pending bits of an incomplete quantum
+    uint buffer;
+    int bits;
+};
+
+// public
+
+Base64Decoder::Base64Decoder(QByteArray &output)
+    : d(new Base64DecoderPrivate(output))
+{
+}
+
+Base64Decoder::~Base64Decoder()
+{
+    delete d;
+}
+
+void Base64Decoder::decode(const QChar *text, int length)
+{
+    // every 4 characters decode into at most 3 bytes, plus 2 bytes from
+    // a pending quantum
+    int outputSize = d->output.size();
+    d->output.resize(outputSize + (length / 4) * 3 + 5);
+    char *output = d->output.data() + outputSize;
+    char *start = output;
+
+    const QChar *end = text + length;
+    while (text < end) {
+        // fast path: an entire quantum without any characters to skip
+        if (d->bits == 0 && end - text >= 4) {
+            int value0 = decodeCharacter(text[0].unicode());
+            int value1 = decodeCharacter(text[1].unicode());
+            int value2 = decodeCharacter(text[2].unicode());
+            int value3 = decodeCharacter(text[3].unicode());
+            if ((value0 | value1 | value2 | value3) >= 0) {
+                uint quantum = (value0 << 18) | (value1 << 12) | (value2 << 6) | value3;
+                output[0] = static_cast<char>(quantum >> 16);
+                output[1] = static_cast<char>(quantum >> 8);
+                output[2] = static_cast<char>(quantum);
+                output += 3;
+                text += 4;
+                continue;
+            }
+        }
+
+        int value = decodeCharacter(text->unicode());
+        ++text;
+        if (value >= 0) {
+            d->buffer = (d->buffer << 6) | value;
+            d->bits += 6;
+            if (d->bits >= 8) {
+                d->bits -= 8;
+                *output++ = static_cast<char>(d->buffer >> d->bits);
+                d->buffer &= (1 << d->bits) - 1;
+            }
+        }
+    }
+    d->output.resize(outputSize + (output - start));
+}
@@ -0,0 +1,68 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef BASE64DECODER_H
+#define BASE64DECODER_H
+
+class QByteArray;
+class QChar;
+
+#include "UtilsLib.h"
+
+class Base64DecoderPrivate;
+
+/*!
+ * Incrementally decodes base64 encoded text, as it is delivered in chunks - for
+ * instance by a QXmlStreamReader - straight from its UTF-16 representation. That
+ * avoids converting the text to Latin-1 and holding the entire encoded text in
+ * memory before decoding it.
+ *
+ * Just like QByteArray::fromBase64() characters outside of the base64 alphabet,
+ * such as whitespace, line breaks and the trailing padding, are skipped.
+ */
+class Base64Decoder
+{
+public:
+    /*!
+     * Creates this Base64Decoder which appends the decoded data to \p output.
+     *
+     * \param output
+     *        the QByteArray the decoded data is appended to; must exist for the
+     *        lifetime of this Base64Decoder
+     */
+    UTILS_API explicit Base64Decoder(QByteArray &output);
+    UTILS_API ~Base64Decoder();
+
+    /*!
+     * Decodes the given chunk of base64 encoded text and appends the result to the
+     * output. Chunks need not be aligned to base64 quanta.
+     *
+     * \param text
+     *        the base64 encoded text
+     * \param length
+     *        the number of characters in \p text
+     */
+    UTILS_API void decode(const QChar *text, int length);
+
+private:
+    Base64DecoderPrivate *d;
+};
+
+#endif // BASE64DECODER_H
@@ -0,0 +1,296 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <cstring>
+
+#include <QtCore/QByteArray>
+#include <QtCore/QIODevice>
+#include <QtCore/QtEndian>
+
+#include "CompressedDevice.h"
+
+class CompressedDevicePrivate
+{
+public:
+    static const char *Magic;
+    static const int MagicLength;
+    static const quint16 FormatVersion;
+    // the uncompressed size of a block
+    static const int BlockSize;
+    // leaves room for incompressible blocks, which grow slightly
+    static const int MaximumCompressedBlockSize;
+    static const int CompressionLevel;
+
+    CompressedDevicePrivate(QIODevice &theDevice)
+        : device(theDevice),
+          position(0),
+          openedDevice(false),
+          endOfStream(false),
+          finished(false),
+          failed(false)
+    {}
+
+    QIODevice &device;
+    // the uncompressed data of the current block
+    QByteArray block;
+    // the read position within the current block
+    int position;
+    bool openedDevice;
+    bool endOfStream;
+    bool finished;
+    bool failed;
+
+    void reset()
+    {
+        block.clear();
+        position = 0;
+        endOfStream = false;
+        finished = false;
+        failed = false;
+    }
+
+    bool writeHeader()
+    {
+        uchar version[2];
+        qToBigEndian(FormatVersion, version);
+        return device.write(Magic, MagicLength) == MagicLength &&
+               device.write(reinterpret_cast<const char *>(version), sizeof(version)) == sizeof(version);
+    }
+
+    bool readHeader()
+    {
+        bool result;
+        QByteArray header = device.read(MagicLength + 2);
+        if (header.size() == MagicLength + 2 && header.startsWith(QByteArray(Magic, MagicLength))) {
+            quint16 version = qFromBigEndian<quint16>(reinterpret_cast<const uchar *>(header.constData() + MagicLength));
+            result = version <= FormatVersion;
+        } else {
+            result = false;
+        }
+        return result;
+    }
+
+    // a block with length 0 terminates the stream
+    bool writeBlock(const QByteArray &data)
+    {
+        QByteArray compressedBlock = data.isEmpty() ? QByteArray() : qCompress(data, CompressionLevel);
+        uchar length[4];
+        qToBigEndian(static_cast<quint32>(compressedBlock.size()), length);
+        return device.write(reinterpret_cast<const char *>(length), sizeof(length)) == sizeof(length) &&
+               device.write(compressedBlock) == compressedBlock.size();
+    }
+
+    bool readBlock()
+    {
+        bool result;
+        uchar length[4];
+        block.clear();
+        position = 0;
+        if (device.read(reinterpret_cast<char *>(length), sizeof(length)) == sizeof(length)) {
+            quint32 compressedSize = qFromBigEndian<quint32>(length);
+            if (compressedSize == 0) {
+                endOfStream = true;
+                result = true;
+            } else if (compressedSize <= static_cast<quint32>(MaximumCompressedBlockSize)) {
+                QByteArray compressedBlock = device.read(compressedSize);
+                if (compressedBlock.size() == static_cast<int>(compressedSize)) {
+                    block = qUncompress(compressedBlock);
+                    result = !block.isEmpty() && block.size() <= BlockSize;
+                } else {
+                    result = false;
+                }
+            } else {
+                result = false;
+            }
+        } else {
+            result = false;
+        }
+        return result;
+    }
+};
+
+const char *CompressedDevicePrivate::Magic = "SCRNZLIB";
+const int CompressedDevicePrivate::MagicLength = 8;
+const quint16 CompressedDevicePrivate::FormatVersion = 1;
+const int CompressedDevicePrivate::BlockSize = 256 * 1024;
+const int CompressedDevicePrivate::MaximumCompressedBlockSize = CompressedDevicePrivate::BlockSize + CompressedDevicePrivate::BlockSize / 100 + 64;
+const int CompressedDevicePrivate::CompressionLevel = 6;
+
+// public
+
+CompressedDevice::CompressedDevice(QIODevice &device, QObject *parent)
+    : QIODevice(parent),
+      d(new CompressedDevicePrivate(device))
+{
+}
+
+CompressedDevice::~CompressedDevice()
+{
+    close();
+    delete d;
+}
+
+bool CompressedDevice::open(OpenMode mode)
+{
+    bool result;
+    OpenMode deviceMode = mode & (QIODevice::ReadOnly | QIODevice::WriteOnly);
+    if (!isOpen() && (deviceMode == QIODevice::ReadOnly || deviceMode == QIODevice::WriteOnly)) {
+        d->reset();
+        if (d->device.isOpen()) {
+            d->openedDevice = false;
+            result = (d->device.openMode() & deviceMode) == deviceMode;
+        } else {
+            d->openedDevice = d->device.open(deviceMode);
+            result = d->openedDevice;
+        }
+        if (result) {
+            if (deviceMode == QIODevice::WriteOnly) {
+                result = d->writeHeader();
+            } else {
+                result = d->readHeader();
+            }
+        }
+        if (result) {
+            // the blocks are our buffer already
+            result = QIODevice::open(deviceMode | QIODevice::Unbuffered);
+        }
+        if (!result && d->openedDevice) {
+            d->device.close();
+            d->openedDevice = false;
+        }
+    } else {
+        result = false;
+    }
+#ifdef DEBUG
+    if (!result) {
+        qDebug("CompressedDevice::open: could not open device, mode: %d", static_cast<int>(mode));
+    }
+#endif
+    return result;
+}
+
+void CompressedDevice::close()
+{
+    if (isOpen()) {
+        if (openMode() & QIODevice::WriteOnly) {
+            finish();
+        }
+        QIODevice::close();
+        if (d->openedDevice) {
+            d->device.close();
+            d->openedDevice = false;
+        }
+        d->block.clear();
+    }
+}
+
+bool CompressedDevice::isSequential() const
+{
+    return true;
+}
+
+bool CompressedDevice::atEnd() const
+{
+    return d->endOfStream && d->position >= d->block.size();
+}
+
+qint64 CompressedDevice::bytesAvailable() const
+{
+    qint64 result = QIODevice::bytesAvailable();
+    if (openMode() & QIODevice::ReadOnly) {
+        result += d->block.size() - d->position;
+    }
+    return result;
+}
+
+bool CompressedDevice::finish()
+{
+    if ((openMode() & QIODevice::WriteOnly) && !d->finished) {
+        d->finished = true;
+        if (!d->failed && !d->block.isEmpty()) {
+            d->failed = !d->writeBlock(d->block);
+        }
+        d->failed = d->failed || !d->writeBlock(QByteArray());
+        d->block.clear();
+    }
+    return !d->failed;
+}
+
+bool CompressedDevice::isCompressed(QIODevice &device)
+{
+    bool result;
+    bool wasOpen = device.isOpen();
+    if (wasOpen || device.open(QIODevice::ReadOnly)) {
+        QByteArray magic = device.peek(CompressedDevicePrivate::MagicLength);
+        result = magic == QByteArray(CompressedDevicePrivate::Magic, CompressedDevicePrivate::MagicLength);
+        if (!wasOpen) {
+            device.close();
+        }
+    } else {
+        result = false;
+    }
+    return result;
+}
+
+// protected
+
+qint64 CompressedDevice::readData(char *data, qint64 maxSize)
+{
+    qint64 result = 0;
+    while (result < maxSize && !d->failed && !d->endOfStream) {
+        if (d->position < d->block.size()) {
+            int count = static_cast<int>(qMin(maxSize - result, static_cast<qint64>(d->block.size() - d->position)));
+            std::memcpy(data + result, d->block.constData() + d->position, count);
+            d->position += count;
+            result += count;
+        } else {
+            d->failed = !d->readBlock();
+        }
+    }
+    if (d->failed) {
+        setErrorString(tr("Corrupt compressed data"));
+#ifdef DEBUG
+        qCritical("CompressedDevice::readData: corrupt compressed data");
+#endif
+        if (result == 0) {
+            result = -1;
+        }
+    }
+    return result;
+}
+
+qint64 CompressedDevice::writeData(const char *data, qint64 maxSize)
+{
+    qint64 result = 0;
+    while (result < maxSize && !d->failed && !d->finished) {
+        int count = static_cast<int>(qMin(maxSize - result, static_cast<qint64>(CompressedDevicePrivate::BlockSize - d->block.size())));
+        d->block.append(data + result, count);
+        result += count;
+        if (d->block.size() == CompressedDevicePrivate::BlockSize) {
+            d->failed = !d->writeBlock(d->block);
+            d->block.clear();
+        }
+    }
+    if (d->failed || d->finished) {
+        setErrorString(tr("Could not write compressed data"));
+        result = -1;
+    }
+    return result;
+}
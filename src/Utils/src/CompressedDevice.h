@@ -0,0 +1,102 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef COMPRESSEDDEVICE_H
+#define COMPRESSEDDEVICE_H
+
+#include <QtCore/QIODevice>
+
+#include "UtilsLib.h"
+
+class CompressedDevicePrivate;
+
+/*!
+ * A sequential QIODevice which transparently compresses the data written to it,
+ * respectively decompresses the data read from it, using zlib. The data is stored
+ * in an underlying QIODevice as a short header followed by a sequence of
+ * independently compressed blocks, each prefixed by its compressed length.
+ *
+ * Data is compressed and decompressed one block at a time: at most one uncompressed
+ * block is held in memory, independent of the total data size.
+ *
+ * \sa #isCompressed(QIODevice &)
+ */
+class CompressedDevice : public QIODevice
+{
+    Q_OBJECT
+public:
+    /*!
+     * Creates this CompressedDevice on top of the given \p device.
+     *
+     * \param device
+     *        the underlying QIODevice which stores the compressed data; must exist
+     *        for the lifetime of this CompressedDevice
+     */
+    UTILS_API explicit CompressedDevice(QIODevice &device, QObject *parent = 0);
+    UTILS_API virtual ~CompressedDevice();
+
+    /*!
+     * Opens this CompressedDevice either QIODevice::ReadOnly or QIODevice::WriteOnly.
+     * The underlying device is opened with the same \p mode, unless it is already
+     * open. When opened for reading the header is validated.
+     *
+     * \return \c true if this CompressedDevice has been opened; \c false else
+     */
+    UTILS_API virtual bool open(OpenMode mode);
+
+    /*!
+     * Closes this CompressedDevice and the underlying device, unless it had already
+     * been opened before #open(OpenMode). When opened for writing #finish() is called
+     * first.
+     */
+    UTILS_API virtual void close();
+
+    UTILS_API virtual bool isSequential() const;
+    UTILS_API virtual bool atEnd() const;
+    UTILS_API virtual qint64 bytesAvailable() const;
+
+    /*!
+     * Compresses the remaining data and terminates the compressed stream. No more data
+     * can be written afterwards.
+     *
+     * \return \c true if all data has been successfully written to the underlying
+     *         device; \c false else
+     */
+    UTILS_API bool finish();
+
+    /*!
+     * Returns whether the \p device contains compressed data, by checking the header
+     * of the \p device. The \p device is opened for reading if necessary and closed
+     * again; an already open \p device is not consumed.
+     *
+     * \return \c true if the \p device data has been written by a CompressedDevice
+     */
+    UTILS_API static bool isCompressed(QIODevice &device);
+
+protected:
+    virtual qint64 readData(char *data, qint64 maxSize);
+    virtual qint64 writeData(const char *data, qint64 maxSize);
+
+private:
+    Q_DISABLE_COPY(CompressedDevice)
+    CompressedDevicePrivate *d;
+};
+
+#endif // COMPRESSEDDEVICE_H
@@ -20,6 +20,10 @@
 
 #include <QtCore/QObject>
 #include <QtCore/QString>
+#include <QtCore/QFile>
+#include <QtCore/QtGlobal>
+
+#include <cstdio>
 
 #include "FileUtils.h"
 
@@ -27,6 +31,7 @@
 
 const QString FileUtils::SceneExtension = QString("xsc");
 const QString FileUtils::TemplateExtension = QString("xst");
+const QString FileUtils::PackageExtension = QString("spk");
 
 QString FileUtils::getOpenImageFileFilter()
 {
@@ -45,3 +50,17 @@ QString FileUtils::getSaveImageFileFilter()
     QString result = QObject::tr("Portable Network Graphics") + "(*.png)";
     return result;
 }
+
+bool FileUtils::replaceFile(const QString &sourceFilePath, const QString &targetFilePath)
+{
+    bool result;
+#ifdef Q_OS_WIN
+    // QFile::rename() does not overwrite existing files
+    QFile::remove(targetFilePath);
+    result = QFile::rename(sourceFilePath, targetFilePath);
+#else
+    // rename(2) atomically replaces the target file
+    result = std::rename(QFile::encodeName(sourceFilePath).constData(), QFile::encodeName(targetFilePath).constData()) == 0;
+#endif
+    return result;
+}
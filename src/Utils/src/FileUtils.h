@@ -31,9 +31,19 @@ public:
 
     UTILS_API static const QString SceneExtension;
     UTILS_API static const QString TemplateExtension;
+    UTILS_API static const QString PackageExtension;
 
     UTILS_API QString static getOpenImageFileFilter();
     UTILS_API QString static getSaveImageFileFilter();
+
+    /*!
+     * Renames the file \p sourceFilePath to \p targetFilePath, replacing an existing
+     * \p targetFilePath. On POSIX systems the file is replaced atomically: readers
+     * either see the previous or the new file, but never a partially written one.
+     *
+     * \return \c true if the file has been replaced; \c false else
+     */
+    UTILS_API static bool replaceFile(const QString &sourceFilePath, const QString &targetFilePath);
 };
 
 #endif // FILEUTILS_H
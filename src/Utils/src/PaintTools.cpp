@@ -47,6 +47,15 @@ QImage PaintTools::createTemplateImage(const QSize &size)
     return result;
 }
 
+QImage PaintTools::createPlaceholderImage(const QSize &size)
+{
+    QImage result = QImage(size, QImage::Format_ARGB32_Premultiplied);
+    QPainter painter(&result);
+    drawBackground(painter, result);
+    painter.end();
+    return result;
+}
+
 QPixmap PaintTools::upperHalf(const QPixmap &pixmap)
 {
     return pixmap.copy(0, 0, pixmap.width(), pixmap.height() / 2);
@@ -47,6 +47,12 @@ public:
      */
     UTILS_API static QImage createTemplateImage(const QSize &size);
 
+    /*!
+     * Creates a placeholder image of the given \p size, to be shown while the
+     * actual image is still being read.
+     */
+    UTILS_API static QImage createPlaceholderImage(const QSize &size);
+
     /*!
      * Returns the upper half of the \p pixmap.
      *
@@ -24,6 +24,8 @@
 #include <QtCore/QStringList>
 #include <QtCore/QSettings>
 #include <QtCore/QDir>
+#include <QtCore/QMutex>
+#include <QtCore/QMutexLocker>
 #include <QtGui/QDesktopServices>
 #include <QtGui/QMainWindow>
 
@@ -44,11 +46,15 @@ public:
     static const qreal DefaultDistanceGestureSensitivity;
     static const int DefaultMaxRecentFiles;
     static const Settings::EditRenderQuality DefaultEditRenderQuality;
+    static const bool DefaultWriteThumbnails;
+    static const bool DefaultCompressSceneFiles;
     static const bool DefaultFullScreen;
     static const QPoint DefaultMainWindowPosition;
     static const QSize DefaultMainWindowSize;
 
     Version version;
+    // guards the settings which are also read in worker threads
+    mutable QMutex mutex;
     QSize maximumImageSize;
     QSize templateSize;
     QString lastImageDirectoryPath;
@@ -58,6 +64,8 @@ public:
     qreal distanceGestureSensitivity;
     int maxRecentFiles;
     Settings::EditRenderQuality editRenderQuality;
+    bool writeThumbnails;
+    bool compressSceneFiles;
     QStringList recentFiles;
 
     QSettings *settings;
@@ -89,6 +97,8 @@ const qreal SettingsPrivate::DefaultRotationGestureSensitivity = 2.0; // these v
 const qreal SettingsPrivate::DefaultDistanceGestureSensitivity = 10.0;
 const int SettingsPrivate::DefaultMaxRecentFiles = 8;
 const Settings::EditRenderQuality SettingsPrivate::DefaultEditRenderQuality = Settings::LowQuality;
+const bool SettingsPrivate::DefaultWriteThumbnails = false;
+const bool SettingsPrivate::DefaultCompressSceneFiles = false;
 const bool SettingsPrivate::DefaultFullScreen = false;
 const QPoint SettingsPrivate::DefaultMainWindowPosition = QPoint();
 const QSize SettingsPrivate::DefaultMainWindowSize = QSize(800, 600);
@@ -110,14 +120,17 @@ void Settings::destroyInstance() {
     }
 }
 
-const QSize &Settings::getMaximumImageSize() const {
+QSize Settings::getMaximumImageSize() const {
+    QMutexLocker mutexLocker(&d->mutex);
     return d->maximumImageSize;
 }
 
 void Settings::setMaximumImageSize(const QSize &maximumImageSize)
 {
-    if (d->maximumImageSize != maximumImageSize) {
+    if (getMaximumImageSize() != maximumImageSize) {
+        d->mutex.lock();
         d->maximumImageSize = maximumImageSize;
+        d->mutex.unlock();
         emit changed();
     }
 }
@@ -264,6 +277,32 @@ void Settings::setEditRenderQuality(EditRenderQuality editRenderQuality)
     }
 }
 
+bool Settings::isWriteThumbnailsEnabled() const
+{
+    return d->writeThumbnails;
+}
+
+void Settings::setWriteThumbnailsEnabled(bool enable)
+{
+    if (d->writeThumbnails != enable) {
+        d->writeThumbnails = enable;
+        emit changed();
+    }
+}
+
+bool Settings::isCompressSceneFilesEnabled() const
+{
+    return d->compressSceneFiles;
+}
+
+void Settings::setCompressSceneFilesEnabled(bool enable)
+{
+    if (d->compressSceneFiles != enable) {
+        d->compressSceneFiles = enable;
+        emit changed();
+    }
+}
+
 Settings::WindowGeometry Settings::getWindowGeometry() const
 {
     WindowGeometry result;
@@ -295,6 +334,7 @@ void Settings::store()
     d->settings->setValue("Version", d->version.toString());
     d->settings->setValue("Scene/MaximumImageSize", d->maximumImageSize);
     d->settings->setValue("Scene/TemplateSize", d->templateSize);
+    d->settings->setValue("Scene/CompressSceneFiles", d->compressSceneFiles);
     d->settings->beginGroup("Paths");
     {
         d->settings->setValue("LastImageDirectoryPath", d->lastImageDirectoryPath);
@@ -306,6 +346,7 @@ void Settings::store()
             d->settings->setValue("RecentFiles", d->recentFiles);
         }
         d->settings->endGroup();
+        d->settings->setValue("WriteThumbnails", d->writeThumbnails);
     }
     d->settings->endGroup();
     d->settings->beginGroup("UI");
@@ -334,8 +375,12 @@ void Settings::restore()
         /*!\todo Settings conversion as necessary */
 #endif
     }
-    d->maximumImageSize = d->settings->value("Scene/MaximumImageSize", SettingsPrivate::DefaultMaximumImageSize).toSize();
+    QSize maximumImageSize = d->settings->value("Scene/MaximumImageSize", SettingsPrivate::DefaultMaximumImageSize).toSize();
+    d->mutex.lock();
+    d->maximumImageSize = maximumImageSize;
+    d->mutex.unlock();
     d->templateSize = d->settings->value("Scene/TemplateSize", SettingsPrivate::DefaultTemplateSize).toSize();
+    d->compressSceneFiles = d->settings->value("Scene/CompressSceneFiles", SettingsPrivate::DefaultCompressSceneFiles).toBool();
     d->settings->beginGroup("Paths");
     {
         d->lastImageDirectoryPath = d->settings->value("LastImageDirectoryPath", SettingsPrivate::DefaultLastImageDirectoryPath).toString();
@@ -347,6 +392,7 @@ void Settings::restore()
             d->recentFiles = d->settings->value("RecentFiles", QStringList()).toStringList();
         }
         d->settings->endGroup();
+        d->writeThumbnails = d->settings->value("WriteThumbnails", SettingsPrivate::DefaultWriteThumbnails).toBool();
     }
     d->settings->endGroup();
     d->settings->beginGroup("UI");
@@ -51,13 +51,14 @@ public:
     };
 
     /*!
-     * The render quality during edit operations.
+     * The minimum render quality during edit operations. The actual render quality
+     * is adapted to the measured rendering time, but never drops below this quality.
      */
     enum EditRenderQuality {
         LowQuality = 0, /*!< Low quality: no anti-aliasing for pixmaps and fonts */
-        MediumQuality = 1, /*!< Not implemented yet. */
-        HighQuality = 2, /*!< Not implemented yet. */
-        MaximumQuality = 3 /*!< Maximum quality: anti-aliasing for pixmaps and fonts */
+        MediumQuality = 1, /*!< Medium quality: smooth pixmap transformation, but no anti-aliasing */
+        HighQuality = 2, /*!< High quality: smooth pixmap transformation and anti-aliasing for pixmaps, but not for fonts */
+        MaximumQuality = 3 /*!< Maximum quality: anti-aliasing for pixmaps and fonts; the render quality is never reduced */
     };
 
     /*!
@@ -66,7 +67,11 @@ public:
     UTILS_API static Settings &getInstance();
     UTILS_API static void destroyInstance();
 
-    UTILS_API const QSize &getMaximumImageSize() const;
+    /*!
+     * Returns the maximum size of images. Thread-safe: also called by the models
+     * when a scene is written in a worker thread.
+     */
+    UTILS_API QSize getMaximumImageSize() const;
 
     /*!
      * \sa #changed()
@@ -134,6 +139,28 @@ public:
 
     UTILS_API EditRenderQuality getEditRenderQuality() const;
 
+    UTILS_API bool isWriteThumbnailsEnabled() const;
+
+    /*!
+     * Enables writing thumbnails of the images read from disk into the
+     * shared thumbnail cache.
+     *
+     * \sa ThumbnailCache
+     * \sa #changed()
+     */
+    UTILS_API void setWriteThumbnailsEnabled(bool enable);
+
+    UTILS_API bool isCompressSceneFilesEnabled() const;
+
+    /*!
+     * Enables writing XML scene and template files compressed. Compressed files
+     * are read transparently, independent of this setting.
+     *
+     * \sa CompressedDevice
+     * \sa #changed()
+     */
+    UTILS_API void setCompressSceneFilesEnabled(bool enable);
+
     UTILS_API WindowGeometry getWindowGeometry() const;
 
     /*!
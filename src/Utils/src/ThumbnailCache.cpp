@@ -0,0 +1,160 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#include <QtCore/QByteArray>
+#include <QtCore/QString>
+#include <QtCore/QSize>
+#include <QtCore/QDir>
+#include <QtCore/QFile>
+#include <QtCore/QFileInfo>
+#include <QtCore/QDateTime>
+#include <QtCore/QUrl>
+#include <QtCore/QCoreApplication>
+#include <QtCore/QCryptographicHash>
+#include <QtGui/QImage>
+#include <QtGui/QImageReader>
+
+#include "ThumbnailCache.h"
+
+// public
+
+QImage ThumbnailCache::readThumbnail(const QString &filePath, QSize *originalSize)
+{
+    QImage result;
+#ifdef Q_WS_X11
+    QFileInfo fileInfo(filePath);
+    if (fileInfo.exists()) {
+        QByteArray uri = QUrl::fromLocalFile(fileInfo.absoluteFilePath()).toEncoded();
+        QString thumbnailFileName = getThumbnailFileName(uri);
+        uint modificationTime = fileInfo.lastModified().toTime_t();
+        result = readValidThumbnail(getCacheDirectoryPath(Large) + thumbnailFileName, uri, modificationTime, originalSize);
+        if (result.isNull()) {
+            result = readValidThumbnail(getCacheDirectoryPath(Normal) + thumbnailFileName, uri, modificationTime, originalSize);
+        }
+    }
+#else
+    Q_UNUSED(filePath)
+    Q_UNUSED(originalSize)
+#endif
+    return result;
+}
+
+bool ThumbnailCache::writeThumbnail(const QString &filePath, const QImage &image)
+{
+    bool result;
+#ifdef Q_WS_X11
+    QFileInfo fileInfo(filePath);
+    if (fileInfo.exists() && !image.isNull()) {
+        QByteArray uri = QUrl::fromLocalFile(fileInfo.absoluteFilePath()).toEncoded();
+        QString cacheDirectoryPath = getCacheDirectoryPath(Large);
+        QString thumbnailFilePath = cacheDirectoryPath + getThumbnailFileName(uri);
+        uint modificationTime = fileInfo.lastModified().toTime_t();
+        if (readValidThumbnail(thumbnailFilePath, uri, modificationTime, 0).isNull()) {
+            result = QDir().mkpath(cacheDirectoryPath);
+            if (result) {
+                // the specification requires the directories to be accessible by the user only
+                QFile::setPermissions(cacheDirectoryPath, QFile::ReadOwner | QFile::WriteOwner | QFile::ExeOwner);
+                QImage thumbnail;
+                if (image.width() > Large || image.height() > Large) {
+                    thumbnail = image.scaled(Large, Large, Qt::KeepAspectRatio, Qt::SmoothTransformation);
+                } else {
+                    thumbnail = image;
+                }
+                thumbnail.setText("Thumb::URI", QString::fromAscii(uri));
+                thumbnail.setText("Thumb::MTime", QString::number(modificationTime));
+                thumbnail.setText("Thumb::Image::Width", QString::number(image.width()));
+                thumbnail.setText("Thumb::Image::Height", QString::number(image.height()));
+                thumbnail.setText("Software", "Screenie");
+                // write to a temporary file first and rename it afterwards, so concurrent readers
+                // never see an incomplete thumbnail
+                QString temporaryFilePath = thumbnailFilePath + QString(".screenie-%1").arg(QCoreApplication::applicationPid());
+                result = thumbnail.save(temporaryFilePath, "PNG");
+                if (result) {
+                    QFile::setPermissions(temporaryFilePath, QFile::ReadOwner | QFile::WriteOwner);
+                    QFile::remove(thumbnailFilePath);
+                    result = QFile::rename(temporaryFilePath, thumbnailFilePath);
+                }
+                if (!result) {
+                    QFile::remove(temporaryFilePath);
+                }
+            }
+        } else {
+            result = true;
+        }
+    } else {
+        result = false;
+    }
+#else
+    Q_UNUSED(filePath)
+    Q_UNUSED(image)
+    result = false;
+#endif
+    return result;
+}
+
+// private
+
+QString ThumbnailCache::getCacheDirectoryPath(ThumbnailSize thumbnailSize)
+{
+    QString result = QFile::decodeName(qgetenv("XDG_CACHE_HOME"));
+    if (result.isEmpty()) {
+        result = QDir::homePath() + "/.cache";
+    }
+    result += "/thumbnails/";
+    switch (thumbnailSize) {
+    case Normal:
+        result += "normal/";
+        break;
+    case Large:
+        result += "large/";
+        break;
+    default:
+#ifdef DEBUG
+        qCritical("ThumbnailCache::getCacheDirectoryPath: UNSUPPORTED thumbnail size: %d", thumbnailSize);
+#endif
+        break;
+    }
+    return result;
+}
+
+QString ThumbnailCache::getThumbnailFileName(const QByteArray &uri)
+{
+    QString result = QString::fromAscii(QCryptographicHash::hash(uri, QCryptographicHash::Md5).toHex()) + ".png";
+    return result;
+}
+
+QImage ThumbnailCache::readValidThumbnail(const QString &thumbnailFilePath, const QByteArray &uri, uint modificationTime, QSize *originalSize)
+{
+    QImage result;
+    QImageReader imageReader(thumbnailFilePath, "PNG");
+    // the text keys are stored in the PNG header, so the thumbnail is only
+    // decoded if it is actually valid
+    bool valid = imageReader.canRead() &&
+                 imageReader.text("Thumb::MTime").toUInt() == modificationTime &&
+                 imageReader.text("Thumb::URI").toAscii() == uri;
+    if (valid) {
+        if (originalSize != 0) {
+            *originalSize = QSize(imageReader.text("Thumb::Image::Width").toInt(),
+                                  imageReader.text("Thumb::Image::Height").toInt());
+        }
+        result = imageReader.read();
+    }
+    return result;
+}
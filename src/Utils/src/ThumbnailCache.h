@@ -0,0 +1,86 @@
+/* This file is part of the Screenie project.
+   Screenie is a fancy screenshot composer.
+
+   Copyright (C) 2008 Ariya Hidayat <ariya.hidayat@gmail.com>
+
+   This program is free software; you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation; either version 2, or (at your option)
+   any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License along
+   with this program; if not, write to the Free Software Foundation,
+   Inc., 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301, USA.
+ */
+
+#ifndef THUMBNAILCACHE_H
+#define THUMBNAILCACHE_H
+
+#include <QtGui/QImage>
+
+class QString;
+class QByteArray;
+class QSize;
+
+#include "UtilsLib.h"
+
+/*!
+ * Provides access to the shared thumbnail cache as specified by the freedesktop.org
+ * <em>Thumbnail Managing Standard</em>: thumbnails are stored as PNG images in
+ * <code>$XDG_CACHE_HOME/thumbnails/{normal,large}</code>, named after the MD5 hash
+ * of the URI of the original file. A thumbnail is only considered valid if its
+ * <code>Thumb::MTime</code> matches the modification time of the original file.
+ *
+ * All methods are reentrant and may be called from worker threads.
+ *
+ * Implementation note: the thumbnail cache is only supported on X11; on other
+ * platforms no thumbnails are found and none are written.
+ */
+class ThumbnailCache
+{
+public:
+    /*!
+     * The thumbnail sizes as defined by the specification.
+     */
+    enum ThumbnailSize {
+        Normal = 128, /*!< Thumbnails of at most 128x128 pixels */
+        Large = 256 /*!< Thumbnails of at most 256x256 pixels */
+    };
+
+    /*!
+     * Reads the thumbnail of the image file \p filePath, if a valid one exists. The
+     * large thumbnail is preferred over the normal one.
+     *
+     * \param filePath
+     *        the path of the original image file
+     * \param originalSize
+     *        set to the size of the original image, if stored along with the thumbnail;
+     *        may be 0
+     * \return the thumbnail; a \em null QImage if no valid thumbnail exists
+     */
+    UTILS_API static QImage readThumbnail(const QString &filePath, QSize *originalSize = 0);
+
+    /*!
+     * Writes a \em large thumbnail of the \p image which has been read from \p filePath
+     * into the thumbnail cache, unless a valid one already exists.
+     *
+     * \param filePath
+     *        the path of the original image file
+     * \param image
+     *        the original image, as read from \p filePath
+     * \return \c true if a valid thumbnail exists after this call; \c false else
+     */
+    UTILS_API static bool writeThumbnail(const QString &filePath, const QImage &image);
+
+private:
+    static QString getCacheDirectoryPath(ThumbnailSize thumbnailSize);
+    static QString getThumbnailFileName(const QByteArray &uri);
+    static QImage readValidThumbnail(const QString &thumbnailFilePath, const QByteArray &uri, uint modificationTime, QSize *originalSize);
+};
+
+#endif // THUMBNAILCACHE_H